@@ -0,0 +1,285 @@
+/**
+ * @file latency_bench.cpp
+ * @brief RDTSC-instrumented latency benchmark suite
+ *
+ * The headers quote latency budgets (20-50 ns RX, 50-80 ns TX). This
+ * suite MEASURES them, per host, so a driver or compiler upgrade can be
+ * qualified against numbers instead of folklore.
+ *
+ * Methodology:
+ * - Per-operation timing with RDTSC; tick→ns conversion uses the runtime
+ *   TSC calibration (common_types.hpp), never a hardcoded frequency
+ * - Samples recorded into a log-bucketed HDR histogram; we report
+ *   p50 / p99 / p99.9 / max — never averages (the tail IS the product)
+ * - A warmup pass before every harness so the first samples don't
+ *   measure cold caches and page faults
+ *
+ * Modes:
+ *   latency_bench                 loopback suite (self-contained, no hardware)
+ *   latency_bench --sim           simulator-driven queue benchmark
+ *                                 (MarketDataSimulator thread → consumer)
+ *   latency_bench --pci <device>  also run CustomNICDriver harnesses
+ *                                 against real hardware (needs root +
+ *                                 a bound PCI device)
+ *
+ * Pin the benchmark to an isolated core (taskset -c N) for stable tails;
+ * on a shared core the p99.9 mostly measures the scheduler.
+ */
+
+#include <ull_nic/common_types.hpp>
+#include <ull_nic/custom_nic_driver.hpp>
+#include <ull_nic/solarflare_efvi.hpp>
+#include <ull_nic/kernel_bypass_nic.hpp>
+#include <ull_nic/latency_histogram.hpp>
+
+#include <cstdio>
+#include <cstring>
+#include <thread>
+
+namespace {
+
+constexpr size_t WARMUP_ITERATIONS = 10'000;
+constexpr size_t BENCH_ITERATIONS = 1'000'000;
+
+// ============================================================================
+// SolarflareEFVI harnesses (simulated backend — runs anywhere)
+// ============================================================================
+
+void bench_efvi_rx(ull_nic::LatencyHistogram& hist) {
+    hft::network::SolarflareEFVI nic;
+    if (!nic.initialize("bench0")) {
+        std::printf("  %-24s skipped (initialize failed)\n", "efvi_poll_rx");
+        return;
+    }
+
+    hft::network::efvi_packet pkt;
+
+    for (size_t i = 0; i < WARMUP_ITERATIONS; i++) {
+        nic.poll_rx(&pkt);
+    }
+
+    const auto& cal = ull_nic::tsc_calibration();
+    for (size_t i = 0; i < BENCH_ITERATIONS; i++) {
+        const uint64_t t0 = ull_nic::get_timestamp();
+        nic.poll_rx(&pkt);
+        const uint64_t t1 = ull_nic::get_timestamp();
+        hist.record(cal.to_ns(t1 - t0));
+    }
+}
+
+// TX in both modes: CTPIO (cut-through PIO through the WC aperture) vs
+// the classic descriptor/DMA path — the comparison that justifies CTPIO
+// for small frames.
+void bench_efvi_tx(ull_nic::LatencyHistogram& ctpio_hist,
+                   ull_nic::LatencyHistogram& dma_hist) {
+    hft::network::SolarflareEFVI nic;
+    if (!nic.initialize("bench0")) {
+        std::printf("  %-24s skipped (initialize failed)\n", "efvi_submit_tx");
+        return;
+    }
+
+    uint8_t frame[64];
+    std::memset(frame, 0xAB, sizeof(frame));
+    const auto& cal = ull_nic::tsc_calibration();
+
+    // CTPIO path (default for frames under the threshold)
+    for (size_t i = 0; i < WARMUP_ITERATIONS; i++) {
+        nic.submit_tx(frame, sizeof(frame));
+        nic.poll_tx_completions();
+    }
+    for (size_t i = 0; i < BENCH_ITERATIONS; i++) {
+        const uint64_t t0 = ull_nic::get_timestamp();
+        nic.submit_tx(frame, sizeof(frame));
+        const uint64_t t1 = ull_nic::get_timestamp();
+        ctpio_hist.record(cal.to_ns(t1 - t0));
+
+        nic.poll_tx_completions();  // Reclaim outside the timed window
+    }
+
+    // Descriptor/DMA path, same frames, CTPIO disabled
+    nic.set_ctpio_enabled(false);
+    for (size_t i = 0; i < WARMUP_ITERATIONS; i++) {
+        nic.submit_tx(frame, sizeof(frame));
+        nic.poll_tx_completions();
+    }
+    for (size_t i = 0; i < BENCH_ITERATIONS; i++) {
+        const uint64_t t0 = ull_nic::get_timestamp();
+        nic.submit_tx(frame, sizeof(frame));
+        const uint64_t t1 = ull_nic::get_timestamp();
+        dma_hist.record(cal.to_ns(t1 - t0));
+
+        nic.poll_tx_completions();
+    }
+    nic.set_ctpio_enabled(true);
+
+    std::printf("  %-24s ctpio=%lu dma=%lu fallbacks=%lu\n", "efvi_tx_mode_counts",
+                static_cast<unsigned long>(nic.ctpio_sends()),
+                static_cast<unsigned long>(nic.dma_sends()),
+                static_cast<unsigned long>(nic.ctpio_fallbacks()));
+}
+
+// ============================================================================
+// CustomNICDriver harnesses (real MMIO — needs a bound PCI device)
+// ============================================================================
+
+void bench_custom_driver(const char* pci_device,
+                         ull_nic::LatencyHistogram& rx_hist,
+                         ull_nic::LatencyHistogram& tx_hist) {
+    hft::hardware::CustomNICDriver driver;
+    if (!driver.initialize(pci_device)) {
+        std::printf("  %-24s skipped (no hardware at %s)\n",
+                    "custom_poll_rx/tx", pci_device);
+        return;
+    }
+
+    uint8_t* data = nullptr;
+    size_t len = 0;
+    uint8_t frame[64];
+    std::memset(frame, 0xCD, sizeof(frame));
+
+    const auto& cal = ull_nic::tsc_calibration();
+
+    // RX: each poll is timed whether or not a packet arrived — the empty
+    // poll cost IS the busy-wait loop's baseline latency
+    for (size_t i = 0; i < BENCH_ITERATIONS; i++) {
+        const uint64_t t0 = ull_nic::get_timestamp();
+        driver.poll_rx(&data, &len);
+        const uint64_t t1 = ull_nic::get_timestamp();
+        rx_hist.record(cal.to_ns(t1 - t0));
+    }
+
+    for (size_t i = 0; i < BENCH_ITERATIONS; i++) {
+        const uint64_t t0 = ull_nic::get_timestamp();
+        driver.submit_tx(frame, sizeof(frame));
+        const uint64_t t1 = ull_nic::get_timestamp();
+        tx_hist.record(cal.to_ns(t1 - t0));
+
+        driver.poll_tx_completion();
+    }
+}
+
+// ============================================================================
+// KernelBypassNIC queue path
+// ============================================================================
+
+/// Loopback: producer and consumer on the same core — measures the pure
+/// queue cost (push + pop) with no cross-core cache traffic
+void bench_queue_loopback(ull_nic::LatencyHistogram& push_hist,
+                          ull_nic::LatencyHistogram& pop_hist) {
+    hft::KernelBypassNIC nic;
+    nic.start();
+
+    hft::MarketTick tick{};
+    tick.depth_levels = hft::MARKET_DEPTH_LEVELS;
+    hft::MarketTick out;
+
+    for (size_t i = 0; i < WARMUP_ITERATIONS; i++) {
+        nic.inject_market_data(tick);
+        nic.get_next_tick(out);
+    }
+
+    const auto& cal = ull_nic::tsc_calibration();
+    for (size_t i = 0; i < BENCH_ITERATIONS; i++) {
+        uint64_t t0 = ull_nic::get_timestamp();
+        nic.inject_market_data(tick);
+        uint64_t t1 = ull_nic::get_timestamp();
+        push_hist.record(cal.to_ns(t1 - t0));
+
+        t0 = ull_nic::get_timestamp();
+        nic.get_next_tick(out);
+        t1 = ull_nic::get_timestamp();
+        pop_hist.record(cal.to_ns(t1 - t0));
+    }
+
+    nic.stop();
+}
+
+/// Simulator-driven: MarketDataSimulator produces on its own thread; the
+/// consumer measures injection→delivery age per tick. This is the number
+/// that includes cross-core cache-line handoff — the realistic one.
+void bench_queue_simulator(ull_nic::LatencyHistogram& hist) {
+    hft::KernelBypassNIC nic;
+    nic.start();
+
+    hft::MarketDataSimulator sim(nic);
+    sim.start(100'000.0);  // 100k ticks/s
+
+    hft::MarketTick tick;
+    size_t received = 0;
+    const size_t target = 200'000;
+
+    while (received < target) {
+        if (nic.get_next_tick(tick)) {
+            // tick.timestamp was stamped with now() at injection
+            const uint64_t age = hft::now() - tick.timestamp;
+            hist.record(age);
+            received++;
+        }
+    }
+
+    sim.stop();
+    nic.stop();
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    bool sim_mode = false;
+    const char* pci_device = nullptr;
+
+    for (int i = 1; i < argc; i++) {
+        if (std::strcmp(argv[i], "--sim") == 0) {
+            sim_mode = true;
+        } else if (std::strcmp(argv[i], "--pci") == 0 && i + 1 < argc) {
+            pci_device = argv[++i];
+        }
+    }
+
+    const auto& cal = ull_nic::tsc_calibration();
+    std::printf("Ultra-Low-Latency NIC — latency benchmark suite\n");
+    std::printf("TSC frequency: %.3f GHz (runtime calibrated)\n\n",
+                static_cast<double>(cal.frequency_hz()) / 1e9);
+
+    if (sim_mode) {
+        std::printf("Simulator-driven queue benchmark "
+                    "(injection→delivery age, cross-thread):\n");
+        ull_nic::LatencyHistogram hist;
+        bench_queue_simulator(hist);
+        hist.print_report("queue_tick_age");
+        return 0;
+    }
+
+    std::printf("Loopback suite (%zu iterations per harness):\n",
+                BENCH_ITERATIONS);
+
+    {
+        ull_nic::LatencyHistogram hist;
+        bench_efvi_rx(hist);
+        hist.print_report("efvi_poll_rx");
+    }
+    {
+        ull_nic::LatencyHistogram hist;
+        ull_nic::LatencyHistogram dma_hist;
+        bench_efvi_tx(hist, dma_hist);
+        hist.print_report("efvi_tx_ctpio");
+        dma_hist.print_report("efvi_tx_dma");
+    }
+    {
+        ull_nic::LatencyHistogram push_hist, pop_hist;
+        bench_queue_loopback(push_hist, pop_hist);
+        push_hist.print_report("queue_push");
+        pop_hist.print_report("queue_pop");
+    }
+
+    if (pci_device) {
+        ull_nic::LatencyHistogram rx_hist, tx_hist;
+        bench_custom_driver(pci_device, rx_hist, tx_hist);
+        rx_hist.print_report("custom_poll_rx");
+        tx_hist.print_report("custom_submit_tx");
+    } else {
+        std::printf("  %-24s skipped (pass --pci <device> to enable)\n",
+                    "custom_poll_rx/tx");
+    }
+
+    return 0;
+}
@@ -27,7 +27,7 @@ int main(int argc, char** argv) {
     std::cout << "========================\n\n";
     
     // Initialize Solarflare NIC
-    ull_nic::SolarflareEFVI nic;
+    hft::network::SolarflareEFVI nic;
     
     if (!nic.initialize(argv[1])) {
         std::cerr << "ERROR: Failed to initialize Solarflare NIC!\n";
@@ -42,7 +42,7 @@ int main(int argc, char** argv) {
     std::cout << "Receiving packets (Press Ctrl+C to stop)...\n\n";
     
     uint64_t packet_count = 0;
-    ull_nic::efvi_packet pkt;
+    hft::network::efvi_packet pkt;
     
     while (running) {
         if (nic.poll_rx(&pkt)) {
@@ -0,0 +1,452 @@
+#pragma once
+
+#include "common_types.hpp"
+#include "dma_arena.hpp"
+#include "custom_nic_driver.hpp"
+
+#include <cstdint>
+#include <cstring>
+#include <cstdio>
+
+#ifdef __linux__
+#include <sys/socket.h>
+#include <sys/mman.h>
+#include <linux/if_xdp.h>
+#include <net/if.h>
+#include <unistd.h>
+#endif
+
+/**
+ * @file af_xdp_driver.hpp
+ * @brief AF_XDP fallback backend with the CustomNICDriver surface
+ *
+ * Why this exists:
+ * ────────────────
+ *
+ * CustomNICDriver needs VFIO and an mmap-able BAR0. Dev boxes and half
+ * the colo spares can't unbind the kernel driver — which means the
+ * strategy binary literally cannot run there. AF_XDP is the kernel's
+ * own fast path: the NIC driver delivers frames into a shared UMEM
+ * region and userspace drains mmap'd descriptor rings, no copy on RX
+ * (with a zero-copy capable driver), no syscall on the RX hot path.
+ *
+ * What it costs: ~1-2 μs instead of 20-50 ns — the kernel driver still
+ * runs its NAPI poll and the XDP program between the wire and our ring.
+ * That's useless for production latency but EXACTLY right for:
+ *
+ * 1. Soak-testing strategy code on commodity hosts (same binary!)
+ * 2. 3 a.m. failover when a BAR mapping breaks on a production host
+ *
+ * Backend selection is COMPILE TIME — the surface (`poll_rx`,
+ * `poll_rx_burst`, `submit_tx`, `poll_tx_completion`, `busy_wait_loop`)
+ * matches CustomNICDriver exactly, so strategy code templated on the
+ * driver type (or built with -DULL_NIC_BACKEND_AFXDP to switch
+ * `DefaultNICDriver`) recompiles with zero virtual dispatch:
+ *
+ * ```cpp
+ * hft::hardware::DefaultNICDriver nic;   // backend chosen at build time
+ * nic.initialize("eth0");
+ * nic.busy_wait_loop([](uint8_t* pkt, size_t len) { ... });
+ * ```
+ *
+ * Deployment note: steering packets into the socket requires an XDP
+ * redirect program on the interface (the stock xdpsock/libxdp one is
+ * fine) — that's a deploy-time `ip link set dev eth0 xdp obj ...`, not
+ * something this header does behind your back.
+ */
+
+namespace hft {
+namespace hardware {
+
+class AFXDPDriver {
+public:
+    /// UMEM geometry: 4096 frames × 2 KB = 8 MB (4 huge pages)
+    static constexpr size_t NUM_FRAMES = 4096;
+    static constexpr size_t FRAME_SIZE = PACKET_BUFFER_SIZE;  // 2048
+    static constexpr size_t RING_SIZE = 2048;  // FILL/COMP/RX/TX rings
+
+    AFXDPDriver()
+        : fd_(-1)
+        , umem_(nullptr)
+        , initialized_(false)
+        , num_free_tx_(0)
+    {}
+
+    ~AFXDPDriver() {
+        cleanup();
+    }
+
+    AFXDPDriver(const AFXDPDriver&) = delete;
+    AFXDPDriver& operator=(const AFXDPDriver&) = delete;
+
+    /**
+     * @brief Bring up the AF_XDP socket on an interface queue
+     *
+     * Setup sequence (all one-time, none of it on the hot path):
+     * 1. Hugepage UMEM arena — the shared frame pool the kernel driver
+     *    DMAs into
+     * 2. XDP_UMEM_REG + four ring setsockopts (FILL/COMP/RX/TX)
+     * 3. mmap the rings (producer/consumer indices + descriptor arrays
+     *    shared with the kernel)
+     * 4. bind — zero-copy mode first, copy mode as the fallback for
+     *    drivers that can't do XDP_ZEROCOPY
+     * 5. Prime the fill ring with the RX half of the frame pool
+     *
+     * @param interface Interface name (e.g. "eth0")
+     * @param queue_id RX queue to attach to (pair with an RSS steer)
+     * @return true on success
+     */
+    bool initialize(const char* interface, uint32_t queue_id = 0) {
+        #ifdef __linux__
+        const unsigned ifindex = if_nametoindex(interface);
+        if (ifindex == 0) {
+            fprintf(stderr, "AF_XDP: unknown interface %s\n", interface);
+            return false;
+        }
+
+        // Step 1: UMEM backing — same hugepage arena as the BAR0 driver
+        if (!umem_arena_.init(NUM_FRAMES * FRAME_SIZE)) {
+            fprintf(stderr, "AF_XDP: UMEM arena allocation failed\n");
+            return false;
+        }
+        umem_ = umem_arena_.base();
+
+        fd_ = socket(AF_XDP, SOCK_RAW, 0);
+        if (fd_ < 0) {
+            fprintf(stderr, "AF_XDP: socket(AF_XDP) failed (CONFIG_XDP_SOCKETS?)\n");
+            return false;
+        }
+
+        // Step 2: register UMEM + size the four rings
+        struct xdp_umem_reg umem_reg;
+        std::memset(&umem_reg, 0, sizeof(umem_reg));
+        umem_reg.addr = reinterpret_cast<uint64_t>(umem_);
+        umem_reg.len = NUM_FRAMES * FRAME_SIZE;
+        umem_reg.chunk_size = FRAME_SIZE;
+        umem_reg.headroom = 0;
+
+        uint32_t ring_size = RING_SIZE;
+        if (setsockopt(fd_, SOL_XDP, XDP_UMEM_REG, &umem_reg, sizeof(umem_reg)) < 0 ||
+            setsockopt(fd_, SOL_XDP, XDP_UMEM_FILL_RING, &ring_size, sizeof(ring_size)) < 0 ||
+            setsockopt(fd_, SOL_XDP, XDP_UMEM_COMPLETION_RING, &ring_size, sizeof(ring_size)) < 0 ||
+            setsockopt(fd_, SOL_XDP, XDP_RX_RING, &ring_size, sizeof(ring_size)) < 0 ||
+            setsockopt(fd_, SOL_XDP, XDP_TX_RING, &ring_size, sizeof(ring_size)) < 0) {
+            fprintf(stderr, "AF_XDP: UMEM/ring setsockopt failed\n");
+            cleanup();
+            return false;
+        }
+
+        // Step 3: mmap the rings the kernel just allocated
+        struct xdp_mmap_offsets off;
+        socklen_t optlen = sizeof(off);
+        if (getsockopt(fd_, SOL_XDP, XDP_MMAP_OFFSETS, &off, &optlen) < 0) {
+            cleanup();
+            return false;
+        }
+
+        if (!map_ring(fill_, off.fr, XDP_UMEM_PGOFF_FILL_RING, sizeof(uint64_t)) ||
+            !map_ring(comp_, off.cr, XDP_UMEM_PGOFF_COMPLETION_RING, sizeof(uint64_t)) ||
+            !map_ring(rx_, off.rx, XDP_PGOFF_RX_RING, sizeof(struct xdp_desc)) ||
+            !map_ring(tx_, off.tx, XDP_PGOFF_TX_RING, sizeof(struct xdp_desc))) {
+            fprintf(stderr, "AF_XDP: ring mmap failed\n");
+            cleanup();
+            return false;
+        }
+
+        // Step 4: bind — try zero-copy, fall back to copy mode
+        struct sockaddr_xdp addr;
+        std::memset(&addr, 0, sizeof(addr));
+        addr.sxdp_family = AF_XDP;
+        addr.sxdp_ifindex = ifindex;
+        addr.sxdp_queue_id = queue_id;
+
+        addr.sxdp_flags = XDP_ZEROCOPY;
+        if (bind(fd_, reinterpret_cast<struct sockaddr*>(&addr), sizeof(addr)) < 0) {
+            addr.sxdp_flags = XDP_COPY;
+            if (bind(fd_, reinterpret_cast<struct sockaddr*>(&addr), sizeof(addr)) < 0) {
+                fprintf(stderr, "AF_XDP: bind failed on %s queue %u "
+                        "(is an XDP program attached?)\n", interface, queue_id);
+                cleanup();
+                return false;
+            }
+            fprintf(stderr, "AF_XDP: zero-copy unsupported on %s, using copy mode\n",
+                    interface);
+        }
+
+        // Step 5: frame pool split — first half RX (lives in the fill
+        // ring), second half TX (lives in our free stack)
+        uint32_t fill_idx = ring_load(fill_.producer);
+        for (size_t i = 0; i < NUM_FRAMES / 2 && i < RING_SIZE; i++) {
+            fill_addr(fill_idx + static_cast<uint32_t>(i)) = i * FRAME_SIZE;
+        }
+        ring_store(fill_.producer,
+                   fill_idx + static_cast<uint32_t>(
+                       (NUM_FRAMES / 2 < RING_SIZE) ? NUM_FRAMES / 2 : RING_SIZE));
+
+        for (size_t i = NUM_FRAMES / 2; i < NUM_FRAMES; i++) {
+            free_tx_frames_[num_free_tx_++] = i * FRAME_SIZE;
+        }
+
+        initialized_ = true;
+        return true;
+        #else
+        (void)interface;
+        (void)queue_id;
+        return false;  // AF_XDP is Linux-only
+        #endif
+    }
+
+    #ifdef __linux__
+
+    /**
+     * @brief Poll for one received frame (same contract as CustomNICDriver)
+     *
+     * Hot path: one acquire load of the kernel's RX producer index, one
+     * descriptor read, one fill-ring repost. No syscalls.
+     *
+     * Performance: ~1-2 μs wire-to-return (the kernel driver + XDP
+     * program sit between the NIC and this ring — that's the deal)
+     */
+    inline bool poll_rx(uint8_t** packet_data, size_t* packet_len) {
+        const uint32_t prod = ring_load(rx_.producer);
+        if (prod == rx_cached_cons_) [[unlikely]] {
+            return false;  // Nothing delivered
+        }
+
+        const struct xdp_desc& desc = rx_desc(rx_cached_cons_);
+        *packet_data = umem_ + desc.addr;
+        *packet_len = desc.len;
+
+        // Recycle the frame into the fill ring so the kernel can reuse it
+        // (the caller must be done with the data before the next poll —
+        // identical lifetime contract to CustomNICDriver::poll_rx)
+        const uint32_t fill_idx = ring_load(fill_.producer);
+        fill_addr(fill_idx) = desc.addr & ~(static_cast<uint64_t>(FRAME_SIZE) - 1);
+        ring_store(fill_.producer, fill_idx + 1);
+
+        rx_cached_cons_++;
+        ring_store(rx_.consumer, rx_cached_cons_);
+        return true;
+    }
+
+    /**
+     * @brief Drain a burst of received frames (amortized index updates)
+     *
+     * Mirrors CustomNICDriver::poll_rx_burst: the producer index is read
+     * once, every available descriptor is consumed in one pass, and the
+     * consumer/fill indices are published once at the end.
+     */
+    inline size_t poll_rx_burst(RxBurstEntry* pkts, size_t max_burst) {
+        const uint32_t prod = ring_load(rx_.producer);
+        uint32_t cons = rx_cached_cons_;
+        uint32_t fill_idx = ring_load(fill_.producer);
+
+        size_t count = 0;
+        while (cons != prod && count < max_burst) {
+            const struct xdp_desc& desc = rx_desc(cons);
+            pkts[count].data = umem_ + desc.addr;
+            pkts[count].len = desc.len;
+            pkts[count].hw_timestamp = 0;  // AF_XDP has no PHC write-back
+
+            fill_addr(fill_idx + static_cast<uint32_t>(count)) =
+                desc.addr & ~(static_cast<uint64_t>(FRAME_SIZE) - 1);
+
+            cons++;
+            count++;
+        }
+
+        if (count > 0) [[likely]] {
+            ring_store(fill_.producer, fill_idx + static_cast<uint32_t>(count));
+            rx_cached_cons_ = cons;
+            ring_store(rx_.consumer, cons);
+        }
+
+        return count;
+    }
+
+    /**
+     * @brief Submit one frame for transmission
+     *
+     * One memcpy into a UMEM TX frame, one descriptor, one producer
+     * bump, then a MSG_DONTWAIT sendto() to kick the kernel's TX path.
+     * The syscall is the price of not owning the doorbell register.
+     */
+    inline bool submit_tx(const uint8_t* data, size_t len) {
+        if (len > FRAME_SIZE) [[unlikely]] {
+            return false;
+        }
+
+        if (num_free_tx_ == 0) [[unlikely]] {
+            poll_tx_completion();  // Try to reclaim before giving up
+            if (num_free_tx_ == 0) {
+                return false;
+            }
+        }
+
+        const uint64_t frame = free_tx_frames_[--num_free_tx_];
+        std::memcpy(umem_ + frame, data, len);
+
+        const uint32_t prod = ring_load(tx_.producer);
+        struct xdp_desc& desc = tx_desc(prod);
+        desc.addr = frame;
+        desc.len = static_cast<uint32_t>(len);
+        desc.options = 0;
+        ring_store(tx_.producer, prod + 1);
+
+        // Kick TX (needed in copy mode and for most zero-copy drivers)
+        sendto(fd_, nullptr, 0, MSG_DONTWAIT, nullptr, 0);
+        return true;
+    }
+
+    /**
+     * @brief Reclaim completed TX frames from the completion ring
+     */
+    inline void poll_tx_completion() {
+        const uint32_t prod = ring_load(comp_.producer);
+        uint32_t cons = comp_cached_cons_;
+
+        while (cons != prod && num_free_tx_ < NUM_FRAMES) {
+            free_tx_frames_[num_free_tx_++] = comp_addr(cons);
+            cons++;
+        }
+
+        if (cons != comp_cached_cons_) {
+            comp_cached_cons_ = cons;
+            ring_store(comp_.consumer, cons);
+        }
+    }
+
+    /**
+     * @brief Busy-wait packet loop — identical shape to CustomNICDriver's
+     *
+     * Same deployment rules apply: isolated core, SCHED_FIFO. The poll
+     * itself is still syscall-free; only the latency floor differs.
+     *
+     * @note Never returns.
+     */
+    template<typename Callback>
+    [[noreturn]] void busy_wait_loop(Callback&& callback) {
+        uint8_t* packet_data;
+        size_t packet_len;
+
+        while (true) {
+            if (poll_rx(&packet_data, &packet_len)) [[likely]] {
+                callback(packet_data, packet_len);
+            }
+            poll_tx_completion();
+        }
+    }
+
+    #endif // __linux__
+
+    bool is_initialized() const { return initialized_; }
+
+    void cleanup() {
+        #ifdef __linux__
+        unmap_ring(fill_);
+        unmap_ring(comp_);
+        unmap_ring(rx_);
+        unmap_ring(tx_);
+        if (fd_ >= 0) {
+            close(fd_);
+            fd_ = -1;
+        }
+        umem_arena_.release();
+        umem_ = nullptr;
+        initialized_ = false;
+        #endif
+    }
+
+private:
+    #ifdef __linux__
+
+    /// One mmap'd XDP ring: kernel-shared producer/consumer + entries
+    struct Ring {
+        void* map = nullptr;
+        size_t map_size = 0;
+        uint32_t* producer = nullptr;
+        uint32_t* consumer = nullptr;
+        void* entries = nullptr;
+    };
+
+    bool map_ring(Ring& ring, const struct xdp_ring_offset& off,
+                  off_t pgoff, size_t entry_size) {
+        ring.map_size = off.desc + RING_SIZE * entry_size;
+        ring.map = mmap(nullptr, ring.map_size, PROT_READ | PROT_WRITE,
+                        MAP_SHARED | MAP_POPULATE, fd_, pgoff);
+        if (ring.map == MAP_FAILED) {
+            ring.map = nullptr;
+            return false;
+        }
+        uint8_t* base = static_cast<uint8_t*>(ring.map);
+        ring.producer = reinterpret_cast<uint32_t*>(base + off.producer);
+        ring.consumer = reinterpret_cast<uint32_t*>(base + off.consumer);
+        ring.entries = base + off.desc;
+        return true;
+    }
+
+    void unmap_ring(Ring& ring) {
+        if (ring.map) {
+            munmap(ring.map, ring.map_size);
+            ring.map = nullptr;
+        }
+    }
+
+    // Kernel-shared index access: acquire on the other side's index,
+    // release on ours — same discipline as the lock-free queues
+    static inline uint32_t ring_load(const uint32_t* idx) {
+        return __atomic_load_n(idx, __ATOMIC_ACQUIRE);
+    }
+    static inline void ring_store(uint32_t* idx, uint32_t value) {
+        __atomic_store_n(idx, value, __ATOMIC_RELEASE);
+    }
+
+    inline struct xdp_desc& rx_desc(uint32_t idx) {
+        return static_cast<struct xdp_desc*>(rx_.entries)[idx & (RING_SIZE - 1)];
+    }
+    inline struct xdp_desc& tx_desc(uint32_t idx) {
+        return static_cast<struct xdp_desc*>(tx_.entries)[idx & (RING_SIZE - 1)];
+    }
+    inline uint64_t& fill_addr(uint32_t idx) {
+        return static_cast<uint64_t*>(fill_.entries)[idx & (RING_SIZE - 1)];
+    }
+    inline uint64_t comp_addr(uint32_t idx) const {
+        return static_cast<const uint64_t*>(comp_.entries)[idx & (RING_SIZE - 1)];
+    }
+
+    Ring fill_;
+    Ring comp_;
+    Ring rx_;
+    Ring tx_;
+
+    uint32_t rx_cached_cons_ = 0;
+    uint32_t comp_cached_cons_ = 0;
+
+    uint64_t free_tx_frames_[NUM_FRAMES];
+
+    #endif // __linux__
+
+    int fd_;
+    ull_nic::DMAArena umem_arena_;
+    uint8_t* umem_;
+    bool initialized_;
+    size_t num_free_tx_;
+};
+
+// ============================================================================
+// Compile-Time Backend Selection
+// ============================================================================
+
+/**
+ * Build with -DULL_NIC_BACKEND_AFXDP to run the same strategy binary on
+ * hosts without VFIO/BAR0 access. No virtual dispatch — the alias picks
+ * the backend at compile time and everything inlines as before.
+ */
+#ifdef ULL_NIC_BACKEND_AFXDP
+using DefaultNICDriver = AFXDPDriver;
+#else
+using DefaultNICDriver = CustomNICDriver;
+#endif
+
+} // namespace hardware
+} // namespace hft
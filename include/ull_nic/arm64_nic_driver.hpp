@@ -1,7 +1,9 @@
 #pragma once
 
 #include "common_types.hpp"
+#include "dma_arena.hpp"
 #include <cstdint>
+#include <cstdio>
 #include <cstring>
 #include <sys/mman.h>
 #include <fcntl.h>
@@ -215,12 +217,16 @@ public:
             return false;
         }
         
-        // Prefetch next descriptor using PRFM
+        // PIPELINE: prefetch descriptor i+1 AND its packet buffer while
+        // the caller processes packet i — the next receive_packet then
+        // hits warm L1 lines instead of two cold loads
         uint32_t next_idx = (rx_head_ + 1) & (RX_RING_SIZE - 1);
         __asm__ __volatile__(
             "prfm pldl1keep, [%0]\n"
+            "prfm pldl1keep, [%1]\n"
             :
-            : "r"(&rx_ring_[next_idx])
+            : "r"(&rx_ring_[next_idx]),
+              "r"(rx_buffers_ + (next_idx * MAX_PACKET_SIZE))
             : "memory"
         );
 #else
@@ -245,6 +251,59 @@ public:
         return true;
     }
     
+    /**
+     * @brief Adaptive receive loop: spin under load, WFE during lulls (OPT-IN)
+     *
+     * Same shape as CustomNICDriver::busy_wait_loop_adaptive, built on
+     * the ARM64 event monitor instead of WAITPKG: after
+     * EMPTY_POLL_THRESHOLD consecutive empty polls, LDAXR arms the
+     * exclusive monitor on the next RX descriptor's status word and WFE
+     * parks the core until the NIC's DMA write clears the monitor
+     * (~sub-100 ns wakeup on Graviton). The load-exclusive + re-check
+     * closes the race where the write lands before the WFE.
+     *
+     * EMPTY_POLL_THRESHOLD = 0 compiles back to a pure spin — the
+     * counter and branch vanish. Hot-session loops should keep plain
+     * polling; this is for the 17:00-18:00 CT window and overnight.
+     *
+     * @note Never returns.
+     */
+    template<uint32_t EMPTY_POLL_THRESHOLD = 4096, typename Callback>
+    [[noreturn]] void busy_wait_loop_adaptive(Callback&& callback) {
+        uint8_t* packet_data;
+        uint16_t packet_len;
+        uint32_t empty_polls = 0;
+
+        while (true) {
+            if (receive_packet(&packet_data, &packet_len)) {
+                callback(packet_data, packet_len);
+                empty_polls = 0;
+                continue;
+            }
+
+            if constexpr (EMPTY_POLL_THRESHOLD > 0) {
+                if (++empty_polls >= EMPTY_POLL_THRESHOLD) {
+                    #ifdef __aarch64__
+                    RxDescriptor* desc = &rx_ring_[rx_head_];
+                    uint32_t status;
+                    // Load-exclusive arms the monitor on the status word;
+                    // WFE sleeps until a write to it (or any event)
+                    __asm__ __volatile__(
+                        "ldaxr %w0, [%1]\n"
+                        : "=r"(status)
+                        : "r"(&desc->status)
+                        : "memory"
+                    );
+                    if (!(status & DESC_STATUS_DD)) {
+                        __asm__ __volatile__("wfe" ::: "memory");
+                    }
+                    #endif
+                    empty_polls = 0;
+                }
+            }
+        }
+    }
+
     /**
      * @brief Send packet (ARM64-optimized with STLR)
      */
@@ -350,6 +409,7 @@ private:
     volatile uint8_t* bar0_base_;
     size_t bar0_size_;
     
+    DMAArena dma_arena_;  // Hugepage arena backing rings and buffers
     RxDescriptor* rx_ring_;
     TxDescriptor* tx_ring_;
     uint8_t* rx_buffers_;
@@ -437,30 +497,31 @@ private:
     
     /**
      * @brief Allocate rings (64-byte aligned for ARM64 cache lines)
+     *
+     * Carved from one hugepage arena (dma_arena.hpp): a single mmap+mlock,
+     * with rings and buffers contiguous for TLB locality.
      */
     bool allocate_rings() {
-        rx_ring_ = static_cast<RxDescriptor*>(
-            aligned_alloc(64, sizeof(RxDescriptor) * RX_RING_SIZE)
-        );
-        if (!rx_ring_) return false;
-        std::memset(rx_ring_, 0, sizeof(RxDescriptor) * RX_RING_SIZE);
-        
-        tx_ring_ = static_cast<TxDescriptor*>(
-            aligned_alloc(64, sizeof(TxDescriptor) * TX_RING_SIZE)
-        );
-        if (!tx_ring_) return false;
-        std::memset(tx_ring_, 0, sizeof(TxDescriptor) * TX_RING_SIZE);
-        
-        // Allocate packet buffers
-        rx_buffers_ = static_cast<uint8_t*>(
-            aligned_alloc(4096, RX_RING_SIZE * MAX_PACKET_SIZE)
-        );
-        if (!rx_buffers_) return false;
-        
-        tx_buffers_ = static_cast<uint8_t*>(
-            aligned_alloc(4096, TX_RING_SIZE * MAX_PACKET_SIZE)
-        );
-        if (!tx_buffers_) return false;
+        const size_t arena_bytes =
+            sizeof(RxDescriptor) * RX_RING_SIZE +
+            sizeof(TxDescriptor) * TX_RING_SIZE +
+            (RX_RING_SIZE + TX_RING_SIZE) * static_cast<size_t>(MAX_PACKET_SIZE) +
+            DMAArena::HUGE_PAGE_SIZE;  // Alignment slack
+
+        if (!dma_arena_.init(arena_bytes)) {
+            return false;
+        }
+
+        rx_ring_ = dma_arena_.allocate_array<RxDescriptor>(RX_RING_SIZE);
+        tx_ring_ = dma_arena_.allocate_array<TxDescriptor>(TX_RING_SIZE);
+        if (!rx_ring_ || !tx_ring_) return false;
+
+        // Packet buffer slabs (page-aligned)
+        rx_buffers_ = dma_arena_.allocate(
+            RX_RING_SIZE * static_cast<size_t>(MAX_PACKET_SIZE), 4096);
+        tx_buffers_ = dma_arena_.allocate(
+            TX_RING_SIZE * static_cast<size_t>(MAX_PACKET_SIZE), 4096);
+        if (!rx_buffers_ || !tx_buffers_) return false;
         
         // Setup RX descriptors
         for (uint32_t i = 0; i < RX_RING_SIZE; i++) {
@@ -541,10 +602,12 @@ private:
             munmap(const_cast<uint8_t*>(bar0_base_), bar0_size_);
         }
         
-        if (rx_ring_) free(rx_ring_);
-        if (tx_ring_) free(tx_ring_);
-        if (rx_buffers_) free(rx_buffers_);
-        if (tx_buffers_) free(tx_buffers_);
+        // Rings and buffers are carved from the arena — one munmap frees all
+        dma_arena_.release();
+        rx_ring_ = nullptr;
+        tx_ring_ = nullptr;
+        rx_buffers_ = nullptr;
+        tx_buffers_ = nullptr;
     }
 };
 
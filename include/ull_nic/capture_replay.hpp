@@ -0,0 +1,274 @@
+#pragma once
+
+#include "packet_capture.hpp"
+#include "kernel_bypass_nic.hpp"
+#include "protocol_descriptors.hpp"
+
+#include <cstdint>
+#include <cstring>
+#include <cstdio>
+
+#ifdef __linux__
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
+/**
+ * @file capture_replay.hpp
+ * @brief Memory-mapped capture replay for deterministic benchmarking
+ *
+ * Why replay instead of MarketDataSimulator:
+ * ──────────────────────────────────────────
+ *
+ * The simulator's one-tick-per-iteration loop with sleep_for between
+ * ticks tops out around 1M ticks/sec, its random walk has none of the
+ * burst structure real feeds have, and std::rand() in the generator is
+ * itself a bottleneck. The only benchmark input we trust is a RECORDING
+ * of the worst five minutes of the CME open, replayed the same way every
+ * run.
+ *
+ * CaptureReplayer mmaps a .ullcap file (the format packet_capture.hpp
+ * writes) and streams it through KernelBypassNIC::inject_batch:
+ *
+ * - PACED mode reproduces the recorded inter-arrival gaps by spinning on
+ *   the TSC — no sleep syscalls, so sub-microsecond gaps survive. The
+ *   file header's TSC frequency rescales recorded deltas to this host's
+ *   clock (a Q32.32 multiplier, same trick as TSCCalibration)
+ * - MAX_SPEED mode ignores timestamps and pushes 64-tick batches as fast
+ *   as the queue accepts them — the throughput ceiling measurement
+ *
+ * The whole file is pre-faulted at open (MAP_POPULATE) so the replay
+ * loop never takes a page fault mid-burst — determinism is the point.
+ */
+
+namespace hft {
+
+/**
+ * Replays a packet capture into a KernelBypassNIC, parsing each record's
+ * payload with a compile-time protocol descriptor (so replay exercises
+ * the SAME parse the live RX path runs).
+ */
+template<typename Protocol = protocol::CME_MDP3>
+class CaptureReplayer {
+public:
+    enum class Pacing : uint8_t {
+        RECORDED,   // Reproduce recorded inter-arrival times (TSC-paced)
+        MAX_SPEED,  // Ignore timestamps, saturate the queue
+    };
+
+    struct ReplayReport {
+        uint64_t ticks_injected = 0;   // Accepted by the queue
+        uint64_t ticks_dropped = 0;    // Queue full (consumer too slow)
+        uint64_t records_skipped = 0;  // PAD / truncated / unparseable
+        uint64_t duration_ns = 0;      // Wall time of the replay
+        double achieved_rate = 0.0;    // Injected ticks per second
+    };
+
+    CaptureReplayer() = default;
+
+    ~CaptureReplayer() {
+        close_file();
+    }
+
+    CaptureReplayer(const CaptureReplayer&) = delete;
+    CaptureReplayer& operator=(const CaptureReplayer&) = delete;
+
+    /**
+     * @brief mmap a .ullcap file read-only and pre-fault every page
+     */
+    bool open(const char* path) {
+        #ifdef __linux__
+        close_file();
+
+        fd_ = ::open(path, O_RDONLY);
+        if (fd_ < 0) {
+            return false;
+        }
+
+        struct stat st;
+        if (fstat(fd_, &st) != 0 ||
+            static_cast<size_t>(st.st_size) < sizeof(ull_nic::CaptureFileHeader)) {
+            close_file();
+            return false;
+        }
+        map_size_ = static_cast<size_t>(st.st_size);
+
+        // MAP_POPULATE: fault every page in NOW, not mid-burst. A page
+        // fault inside the paced loop would smear the very inter-arrival
+        // structure we're replaying to reproduce.
+        void* map = mmap(nullptr, map_size_, PROT_READ,
+                         MAP_PRIVATE | MAP_POPULATE, fd_, 0);
+        if (map == MAP_FAILED) {
+            close_file();
+            return false;
+        }
+        base_ = static_cast<const uint8_t*>(map);
+
+        const auto* hdr = reinterpret_cast<const ull_nic::CaptureFileHeader*>(base_);
+        if (hdr->magic != ull_nic::CaptureFileHeader::MAGIC ||
+            hdr->tsc_freq_hz == 0) {
+            close_file();
+            return false;
+        }
+        file_tsc_freq_ = hdr->tsc_freq_hz;
+        return true;
+        #else
+        (void)path;
+        return false;
+        #endif
+    }
+
+    /**
+     * @brief Replay the whole capture into the NIC's inject path
+     *
+     * Run this from a pinned core — in paced mode the loop busy-spins on
+     * the TSC between records exactly like the production poll loop.
+     */
+    ReplayReport replay(KernelBypassNIC& nic, Pacing pacing = Pacing::RECORDED) {
+        ReplayReport report;
+        if (!base_) {
+            return report;
+        }
+
+        // Recorded deltas are in the CAPTURE HOST's TSC ticks; rescale
+        // to this host's clock with a Q32.32 fixed-point ratio — one
+        // 128-bit multiply per record, no division, no floating point
+        // in the paced loop.
+        const uint64_t local_freq = ull_nic::tsc_calibration().frequency_hz();
+        const uint64_t ratio_q32 =
+            (static_cast<ull_nic::detail::u128>(local_freq) << 32) / file_tsc_freq_;
+
+        constexpr size_t BATCH = 64;
+        MarketTick batch[BATCH];
+        size_t batched = 0;
+
+        const uint8_t* cursor = base_ + sizeof(ull_nic::CaptureFileHeader);
+        const uint8_t* end = base_ + map_size_;
+
+        uint64_t first_record_tsc = 0;
+        uint64_t replay_start_tsc = 0;
+        const uint64_t wall_start = now();
+
+        while (cursor + sizeof(ull_nic::CaptureRecordHeader) <= end) {
+            const auto* rec =
+                reinterpret_cast<const ull_nic::CaptureRecordHeader*>(cursor);
+            // Records pad payloads to 16 bytes (see packet_capture.hpp);
+            // PAD fillers carry an already-aligned span in len
+            const size_t padded_len = (rec->len + 15) & ~size_t(15);
+            cursor += sizeof(ull_nic::CaptureRecordHeader);
+
+            if (cursor + padded_len > end) [[unlikely]] {
+                break;  // Truncated tail (capture cut mid-record)
+            }
+
+            if (rec->flags & ull_nic::CaptureRecordHeader::FLAG_PAD) {
+                cursor += padded_len;
+                report.records_skipped++;
+                continue;
+            }
+
+            double price;
+            uint32_t qty;
+            if (!protocol::parse<Protocol>(cursor, rec->len, &price, &qty)) {
+                cursor += padded_len;
+                report.records_skipped++;
+                continue;
+            }
+
+            if (pacing == Pacing::RECORDED) {
+                if (first_record_tsc == 0) {
+                    first_record_tsc = rec->timestamp;
+                    replay_start_tsc = ull_nic::get_timestamp();
+                } else {
+                    // Spin to this record's deadline — no syscalls, so
+                    // even sub-microsecond recorded gaps are honored
+                    const uint64_t delta_file = rec->timestamp - first_record_tsc;
+                    const uint64_t delta_local = static_cast<uint64_t>(
+                        (static_cast<ull_nic::detail::u128>(delta_file) * ratio_q32) >> 32);
+                    const uint64_t deadline = replay_start_tsc + delta_local;
+                    while (ull_nic::get_timestamp() < deadline) {
+                        #if defined(__x86_64__) || defined(__i386__)
+                        __builtin_ia32_pause();
+                        #endif
+                    }
+                }
+            }
+
+            MarketTick& tick = batch[batched++];
+            tick = MarketTick{};
+            tick.timestamp = now();
+            tick.mid_price = price;
+            tick.bid_price = price;
+            tick.ask_price = price;
+            tick.trade_volume = qty;
+            tick.depth_levels = 0;
+
+            // Paced mode injects per record (a 64-deep batch would smear
+            // the arrival times we just spun to reproduce); max-speed
+            // amortizes the queue's tail publish across 64 ticks
+            const bool flush = (pacing == Pacing::RECORDED) || (batched == BATCH);
+            if (flush) {
+                const size_t accepted = nic.inject_batch(batch, batched);
+                report.ticks_injected += accepted;
+                report.ticks_dropped += batched - accepted;
+                batched = 0;
+            }
+
+            cursor += padded_len;
+        }
+
+        if (batched > 0) {
+            const size_t accepted = nic.inject_batch(batch, batched);
+            report.ticks_injected += accepted;
+            report.ticks_dropped += batched - accepted;
+        }
+
+        report.duration_ns = now() - wall_start;
+        if (report.duration_ns > 0) {
+            report.achieved_rate = static_cast<double>(report.ticks_injected) *
+                                   1e9 / static_cast<double>(report.duration_ns);
+        }
+        return report;
+    }
+
+    /// TSC frequency of the host that RECORDED the capture
+    uint64_t capture_tsc_freq() const { return file_tsc_freq_; }
+
+    size_t file_size() const { return map_size_; }
+
+    static void print_report(const ReplayReport& r, const char* label) {
+        std::printf("[replay:%s] injected=%lu dropped=%lu skipped=%lu "
+                    "duration=%.3f ms rate=%.2f M ticks/s\n",
+                    label,
+                    static_cast<unsigned long>(r.ticks_injected),
+                    static_cast<unsigned long>(r.ticks_dropped),
+                    static_cast<unsigned long>(r.records_skipped),
+                    static_cast<double>(r.duration_ns) / 1e6,
+                    r.achieved_rate / 1e6);
+    }
+
+private:
+    void close_file() {
+        #ifdef __linux__
+        if (base_) {
+            munmap(const_cast<uint8_t*>(base_), map_size_);
+            base_ = nullptr;
+        }
+        if (fd_ >= 0) {
+            ::close(fd_);
+            fd_ = -1;
+        }
+        #endif
+        map_size_ = 0;
+        file_tsc_freq_ = 0;
+    }
+
+    const uint8_t* base_ = nullptr;
+    size_t map_size_ = 0;
+    uint64_t file_tsc_freq_ = 0;
+    int fd_ = -1;
+};
+
+} // namespace hft
@@ -1,9 +1,15 @@
 #pragma once
 
+#include <atomic>
 #include <cstdint>
 #include <ctime>
 #include <chrono>
 
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>  // __rdtsc
+#include <cpuid.h>      // __get_cpuid (TSC frequency enumeration)
+#endif
+
 /**
  * @file common_types.hpp
  * @brief Common types and utilities for Ultra-Low-Latency NIC drivers
@@ -16,6 +22,17 @@
 
 namespace ull_nic {
 
+namespace detail {
+// 128-bit intermediate for overflow-free tick<->ns conversion.
+// __extension__ keeps the compiler extension out of -Wpedantic's view
+// (examples build with it), without giving up the single-multiply path.
+#if defined(__SIZEOF_INT128__)
+__extension__ typedef unsigned __int128 u128;
+#else
+typedef uint64_t u128;  // Narrow fallback: conversions may clamp sooner
+#endif
+} // namespace detail
+
 // ============================================================================
 // High-Resolution Timestamp Utilities
 // ============================================================================
@@ -46,12 +63,188 @@ inline uint64_t get_timestamp() {
  * @param ticks TSC ticks from RDTSC instruction
  * @param tsc_freq TSC frequency in Hz (typically 2-4 GHz)
  * @return Nanoseconds
- * 
- * To calibrate TSC frequency on Linux:
- * cat /sys/devices/system/cpu/cpu0/cpufreq/base_frequency
+ *
+ * Prefer TSCCalibration below: it measures the REAL frequency at startup
+ * (fleets mix 2.1 and 3.4 GHz hosts — a hardcoded default is wrong on
+ * most of them) and converts with a single multiply+shift.
+ *
+ * The intermediate product is computed in 128 bits: the old
+ * (ticks * 1e9) / freq form overflowed uint64 after ~18 seconds of
+ * uptime at 3 GHz, silently corrupting every exported latency number.
  */
 inline uint64_t tsc_to_ns(uint64_t ticks, uint64_t tsc_freq = 2'800'000'000) {
-    return (ticks * 1'000'000'000) / tsc_freq;
+    return static_cast<uint64_t>(
+        (static_cast<detail::u128>(ticks) * 1'000'000'000) / tsc_freq);
+}
+
+// ============================================================================
+// TSC Calibration (measured frequency, fixed-point hot-path conversion)
+// ============================================================================
+
+/**
+ * @class TSCCalibration
+ * @brief Runtime TSC frequency calibration with overflow-free conversion
+ *
+ * Calibration sources, in order of preference:
+ * 1. CPUID leaf 0x15 (TSC/crystal ratio — exact on Skylake+ parts that
+ *    report the crystal frequency)
+ * 2. Measurement against CLOCK_MONOTONIC_RAW over a configurable window
+ *    (~0.01% accuracy with the default 50 ms window)
+ *
+ * The conversion is precomputed as a Q32.32 fixed-point multiplier:
+ *
+ *     ns = (ticks * ns_per_tick_q32) >> 32
+ *
+ * One 64x64→128 multiply and one shift on the hot path — no division,
+ * no overflow for any uptime (the 128-bit product cannot wrap).
+ *
+ * For multi-day runs call recalibrate() periodically (e.g. once a minute
+ * from a housekeeping thread) to track crystal drift; both conversion
+ * fields are atomics updated with relaxed stores, so hot-path readers
+ * never tear or race.
+ */
+class TSCCalibration {
+public:
+    /**
+     * @brief Calibrate at startup
+     * @param window_ns Measurement window (ignored if CPUID 0x15 is exact)
+     */
+    explicit TSCCalibration(uint64_t window_ns = 50'000'000) {
+        uint64_t freq = read_cpuid_tsc_freq();
+        if (freq == 0) {
+            freq = measure_tsc_freq(window_ns);
+        }
+        set_frequency(freq);
+    }
+
+    /**
+     * @brief Convert TSC ticks to nanoseconds (HOT PATH)
+     *
+     * Performance: ~1-2 ns (one mul + shift, no division)
+     */
+    inline uint64_t to_ns(uint64_t ticks) const {
+        return static_cast<uint64_t>(
+            (static_cast<detail::u128>(ticks) *
+             ns_per_tick_q32_.load(std::memory_order_relaxed)) >> 32);
+    }
+
+    /**
+     * @brief Convert a nanosecond interval to TSC ticks
+     */
+    inline uint64_t to_ticks(uint64_t ns) const {
+        return static_cast<uint64_t>(
+            (static_cast<detail::u128>(ns) *
+             tsc_freq_hz_.load(std::memory_order_relaxed)) / 1'000'000'000);
+    }
+
+    /// Calibrated TSC frequency in Hz
+    uint64_t frequency_hz() const {
+        return tsc_freq_hz_.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Re-measure and update the multiplier (drift tracking)
+     *
+     * Safe to call from a housekeeping thread while hot paths convert:
+     * both fields are std::atomic, updated with relaxed stores. The two
+     * stores are not one atomic unit, so a converter running DURING the
+     * update can pair a fresh multiplier with a stale frequency (or vice
+     * versa) for one conversion — but both values encode the same
+     * crystal rate to within the measurement's ~0.01%, so the worst case
+     * is a sub-ppm error on a single interval, never a torn value.
+     */
+    void recalibrate(uint64_t window_ns = 50'000'000) {
+        const uint64_t measured = measure_tsc_freq(window_ns);
+        if (measured != 0) {
+            set_frequency(measured);
+        }
+    }
+
+private:
+    std::atomic<uint64_t> tsc_freq_hz_{0};
+    std::atomic<uint64_t> ns_per_tick_q32_{0};  // Q32.32: (1e9 << 32) / tsc_freq
+
+    /// Publish a new frequency and its derived multiplier (relaxed stores)
+    void set_frequency(uint64_t freq_hz) {
+        if (freq_hz == 0) {
+            freq_hz = 1'000'000'000;  // Defensive: 1 tick = 1 ns
+        }
+        tsc_freq_hz_.store(freq_hz, std::memory_order_relaxed);
+        ns_per_tick_q32_.store(
+            static_cast<uint64_t>(
+                (static_cast<detail::u128>(1'000'000'000) << 32) / freq_hz),
+            std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Exact TSC frequency from CPUID leaf 0x15 (0 if unavailable)
+     */
+    static uint64_t read_cpuid_tsc_freq() {
+        #if defined(__x86_64__) || defined(__i386__)
+        unsigned int eax = 0, ebx = 0, ecx = 0, edx = 0;
+        if (__get_cpuid(0x15, &eax, &ebx, &ecx, &edx)) {
+            // eax = crystal/TSC denominator, ebx = numerator,
+            // ecx = crystal frequency in Hz (0 on many parts)
+            if (eax != 0 && ebx != 0 && ecx != 0) {
+                return static_cast<uint64_t>(ecx) * ebx / eax;
+            }
+        }
+        #endif
+        return 0;
+    }
+
+    /**
+     * @brief Measure TSC frequency against CLOCK_MONOTONIC_RAW
+     *
+     * MONOTONIC_RAW is immune to NTP slewing — exactly what we want when
+     * the goal is to learn the crystal's true rate.
+     */
+    static uint64_t measure_tsc_freq(uint64_t window_ns) {
+        const uint64_t wall_start = monotonic_raw_ns();
+        const uint64_t tsc_start = get_timestamp();
+
+        // Spin out the measurement window (calibration is startup-only;
+        // burning one core for 50 ms here is fine)
+        uint64_t wall_end = wall_start;
+        while (wall_end - wall_start < window_ns) {
+            wall_end = monotonic_raw_ns();
+        }
+        const uint64_t tsc_end = get_timestamp();
+
+        const uint64_t elapsed_ns = wall_end - wall_start;
+        if (elapsed_ns == 0) {
+            return 0;
+        }
+
+        return static_cast<uint64_t>(
+            (static_cast<detail::u128>(tsc_end - tsc_start) * 1'000'000'000)
+            / elapsed_ns);
+    }
+
+    static uint64_t monotonic_raw_ns() {
+        struct timespec ts;
+        #ifdef CLOCK_MONOTONIC_RAW
+        clock_gettime(CLOCK_MONOTONIC_RAW, &ts);
+        #else
+        clock_gettime(CLOCK_MONOTONIC, &ts);
+        #endif
+        return static_cast<uint64_t>(ts.tv_sec) * 1'000'000'000 + ts.tv_nsec;
+    }
+};
+
+/**
+ * @brief Process-wide calibration instance (calibrated on first use)
+ */
+inline TSCCalibration& tsc_calibration() {
+    static TSCCalibration instance;
+    return instance;
+}
+
+/**
+ * @brief Convert TSC ticks to nanoseconds using the calibrated frequency
+ */
+inline uint64_t ticks_to_ns(uint64_t ticks) {
+    return tsc_calibration().to_ns(ticks);
 }
 
 /**
@@ -0,0 +1,405 @@
+#pragma once
+
+#include "market_types.hpp"
+#include "lockfree_queue.hpp"
+
+#include <cstdint>
+#include <cstring>
+
+/**
+ * @file compact_tick.hpp
+ * @brief Delta-encoded tick format: one cache line per tick, end to end
+ *
+ * The problem with queueing full MarketTicks:
+ * ───────────────────────────────────────────
+ *
+ * MarketTick carries complete 10-level bid/ask price and size arrays —
+ * roughly 400 bytes per slot. LockFreeQueue<MarketTick, 16384> is ~6 MB:
+ * that blows L2 and a healthy slice of L3 on the polling core, and every
+ * push copies the whole struct even when ONE level changed (which is the
+ * overwhelmingly common case on a real book).
+ *
+ * The compact format sends what changed:
+ *
+ * - A 64-byte, cache-line-aligned queue slot: fixed header + up to two
+ *   delta-encoded level updates. The median tick (one level touched)
+ *   is exactly one slot — one line written by the producer, one line
+ *   read by the consumer, ~1 MB total queue footprint
+ * - Ticks touching more levels span a chain of slots (CONTINUATION /
+ *   END flags); the consumer materializes once, at END
+ * - Snapshots reuse the same machinery: a SNAPSHOT-flagged chain resets
+ *   the consumer book and replays all 20 levels — that's the recovery
+ *   path (startup, gap detection), not the steady state
+ *
+ * The consumer side keeps an incremental order book per asset and
+ * applies deltas IN PLACE — no full-array copies anywhere on the path.
+ *
+ * Usage:
+ * ```cpp
+ * hft::CompactTickChannel channel;
+ *
+ * // Producer (poll/parse thread)
+ * channel.publish(full_tick);          // encodes deltas internally
+ *
+ * // Consumer (strategy thread)
+ * hft::MarketTick tick;
+ * while (channel.poll(tick)) { strategy.on_tick(tick); }
+ * ```
+ */
+
+namespace hft {
+
+// ============================================================================
+// Wire Format
+// ============================================================================
+
+/// One price-level change: side+level packed in a byte, price, size
+struct CompactLevelUpdate {
+    double price;               // 8 bytes
+    uint32_t size;              // 4 bytes
+    uint8_t side_and_level;     // bit 7: 0=bid 1=ask; bits 0-6: level index
+    uint8_t _reserved[3];       // 16 bytes total
+};
+
+static_assert(sizeof(CompactLevelUpdate) == 16,
+              "CompactLevelUpdate must pack to 16 bytes");
+
+/**
+ * One queue slot: exactly one cache line.
+ *
+ * A logical tick is 1..N slots; N > 1 only when more than two levels
+ * changed (rare) or for snapshot chains (recovery only).
+ */
+struct alignas(64) CompactTick {
+    // Flags
+    static constexpr uint8_t FLAG_SNAPSHOT = 0x01;  // Chain resets the book
+    static constexpr uint8_t FLAG_CONTINUATION = 0x02;  // Not the first slot
+    static constexpr uint8_t FLAG_END = 0x04;  // Last slot of the tick
+
+    static constexpr size_t MAX_UPDATES = 2;
+
+    uint64_t timestamp;          // 8
+    uint32_t asset_id;           // 4
+    uint8_t flags;               // 1
+    uint8_t num_updates;         // 1
+    Side trade_side;             // 1
+    uint8_t _pad;                // 1
+    uint32_t trade_volume;       // 4  (20)
+    double mid_price;            // 8  (28, +4 implicit align pad before)
+
+    CompactLevelUpdate updates[MAX_UPDATES];  // 32
+
+    static constexpr uint8_t pack_side_level(bool is_ask, uint8_t level) {
+        return static_cast<uint8_t>((is_ask ? 0x80 : 0x00) | (level & 0x7F));
+    }
+};
+
+static_assert(sizeof(CompactTick) == 64,
+              "CompactTick must be exactly one cache line");
+
+// ============================================================================
+// Incremental Order Book (consumer side)
+// ============================================================================
+
+/**
+ * Per-asset book state that deltas apply to IN PLACE.
+ *
+ * materialize() is the only full-array copy on the consumer path, and it
+ * happens once per logical tick (at the END slot), not per slot.
+ */
+class IncrementalOrderBook {
+public:
+    IncrementalOrderBook() {
+        reset();
+    }
+
+    void reset() {
+        std::memset(bid_prices_, 0, sizeof(bid_prices_));
+        std::memset(ask_prices_, 0, sizeof(ask_prices_));
+        std::memset(bid_sizes_, 0, sizeof(bid_sizes_));
+        std::memset(ask_sizes_, 0, sizeof(ask_sizes_));
+        mid_price_ = 0.0;
+        valid_ = false;
+    }
+
+    /// Apply one slot's updates in place (HOT PATH: ≤2 stores per slot)
+    inline void apply(const CompactTick& slot) {
+        if (slot.flags & CompactTick::FLAG_SNAPSHOT) {
+            if (!(slot.flags & CompactTick::FLAG_CONTINUATION)) {
+                reset();  // First slot of a snapshot chain: clean book
+            }
+            valid_ = true;
+        }
+
+        for (uint8_t u = 0; u < slot.num_updates; u++) {
+            const CompactLevelUpdate& upd = slot.updates[u];
+            const uint8_t level = upd.side_and_level & 0x7F;
+            if (level >= MARKET_DEPTH_LEVELS) [[unlikely]] {
+                continue;
+            }
+            if (upd.side_and_level & 0x80) {
+                ask_prices_[level] = upd.price;
+                ask_sizes_[level] = upd.size;
+            } else {
+                bid_prices_[level] = upd.price;
+                bid_sizes_[level] = upd.size;
+            }
+        }
+
+        mid_price_ = slot.mid_price;
+    }
+
+    /// Produce a full MarketTick view of the current book
+    void materialize(const CompactTick& last_slot, MarketTick& out) const {
+        out.timestamp = last_slot.timestamp;
+        out.asset_id = last_slot.asset_id;
+        out.depth_levels = MARKET_DEPTH_LEVELS;
+        out.mid_price = mid_price_;
+        out.bid_price = bid_prices_[0];
+        out.ask_price = ask_prices_[0];
+        out.bid_size = bid_sizes_[0];
+        out.ask_size = ask_sizes_[0];
+        out.trade_volume = last_slot.trade_volume;
+        out.trade_side = last_slot.trade_side;
+
+        std::memcpy(out.bid_prices, bid_prices_, sizeof(bid_prices_));
+        std::memcpy(out.ask_prices, ask_prices_, sizeof(ask_prices_));
+        std::memcpy(out.bid_sizes, bid_sizes_, sizeof(bid_sizes_));
+        std::memcpy(out.ask_sizes, ask_sizes_, sizeof(ask_sizes_));
+    }
+
+    bool valid() const { return valid_; }
+    void mark_valid() { valid_ = true; }
+
+private:
+    double bid_prices_[MARKET_DEPTH_LEVELS];
+    double ask_prices_[MARKET_DEPTH_LEVELS];
+    uint32_t bid_sizes_[MARKET_DEPTH_LEVELS];
+    uint32_t ask_sizes_[MARKET_DEPTH_LEVELS];
+    double mid_price_;
+    bool valid_;
+};
+
+// ============================================================================
+// Channel: encoder + 64-byte-slot queue + consumer books
+// ============================================================================
+
+/**
+ * SPSC channel carrying delta-encoded ticks.
+ *
+ * Producer keeps a shadow book per asset to diff against; the first tick
+ * for an asset (and any explicit resync) goes out as a snapshot chain.
+ * Queue footprint: 16384 × 64 B = 1 MB (vs ~6 MB for full MarketTicks).
+ */
+template<size_t QueueCapacity = 16384, size_t MaxAssets = 64>
+class CompactTickChannel {
+public:
+    CompactTickChannel() = default;
+
+    // ========================================================================
+    // Producer side
+    // ========================================================================
+
+    /**
+     * @brief Encode a full tick as deltas and enqueue (HOT PATH)
+     *
+     * Diffs against the producer's shadow book; the median tick (one
+     * level changed) becomes ONE 64-byte slot. First sight of an asset
+     * emits a snapshot chain instead.
+     *
+     * @return false if the queue lacked room for the whole chain (the
+     *         tick is dropped atomically — consumers never see half)
+     */
+    bool publish(const MarketTick& tick) {
+        if (tick.asset_id >= MaxAssets) [[unlikely]] {
+            return false;
+        }
+
+        ShadowBook& shadow = shadow_books_[tick.asset_id];
+        if (!shadow.seen) [[unlikely]] {
+            return publish_snapshot(tick);
+        }
+
+        // Diff the shadow book: collect changed levels
+        CompactLevelUpdate updates[2 * MARKET_DEPTH_LEVELS];
+        size_t n_updates = 0;
+
+        for (uint8_t lvl = 0; lvl < MARKET_DEPTH_LEVELS; lvl++) {
+            if (tick.bid_prices[lvl] != shadow.bid_prices[lvl] ||
+                tick.bid_sizes[lvl] != shadow.bid_sizes[lvl]) {
+                updates[n_updates].price = tick.bid_prices[lvl];
+                updates[n_updates].size = tick.bid_sizes[lvl];
+                updates[n_updates].side_and_level =
+                    CompactTick::pack_side_level(false, lvl);
+                n_updates++;
+            }
+            if (tick.ask_prices[lvl] != shadow.ask_prices[lvl] ||
+                tick.ask_sizes[lvl] != shadow.ask_sizes[lvl]) {
+                updates[n_updates].price = tick.ask_prices[lvl];
+                updates[n_updates].size = tick.ask_sizes[lvl];
+                updates[n_updates].side_and_level =
+                    CompactTick::pack_side_level(true, lvl);
+                n_updates++;
+            }
+        }
+
+        if (!enqueue_chain(tick, updates, n_updates, /*snapshot=*/false)) {
+            return false;
+        }
+
+        shadow.update_from(tick);
+        return true;
+    }
+
+    /**
+     * @brief Force a full snapshot chain (RECOVERY path, not steady state)
+     *
+     * Use at startup, after detected gaps, or when a late-joining
+     * consumer needs the whole book. 10 slots for a full 10-level book.
+     */
+    bool publish_snapshot(const MarketTick& tick) {
+        if (tick.asset_id >= MaxAssets) [[unlikely]] {
+            return false;
+        }
+
+        CompactLevelUpdate updates[2 * MARKET_DEPTH_LEVELS];
+        size_t n_updates = 0;
+        for (uint8_t lvl = 0; lvl < MARKET_DEPTH_LEVELS; lvl++) {
+            updates[n_updates].price = tick.bid_prices[lvl];
+            updates[n_updates].size = tick.bid_sizes[lvl];
+            updates[n_updates].side_and_level =
+                CompactTick::pack_side_level(false, lvl);
+            n_updates++;
+            updates[n_updates].price = tick.ask_prices[lvl];
+            updates[n_updates].size = tick.ask_sizes[lvl];
+            updates[n_updates].side_and_level =
+                CompactTick::pack_side_level(true, lvl);
+            n_updates++;
+        }
+
+        if (!enqueue_chain(tick, updates, n_updates, /*snapshot=*/true)) {
+            return false;
+        }
+
+        ShadowBook& shadow = shadow_books_[tick.asset_id];
+        shadow.update_from(tick);
+        shadow.seen = true;
+        return true;
+    }
+
+    // ========================================================================
+    // Consumer side
+    // ========================================================================
+
+    /**
+     * @brief Pop and apply slots until a logical tick completes (HOT PATH)
+     *
+     * Applies deltas to the per-asset incremental book in place; `out`
+     * is materialized only when an END slot arrives.
+     *
+     * @return true when a complete tick was materialized into out
+     */
+    bool poll(MarketTick& out) {
+        CompactTick slot;
+        while (queue_.pop(slot)) {
+            if (slot.asset_id >= MaxAssets) [[unlikely]] {
+                continue;
+            }
+
+            IncrementalOrderBook& book = books_[slot.asset_id];
+            book.apply(slot);
+
+            if (slot.flags & CompactTick::FLAG_END) {
+                if (!book.valid()) [[unlikely]] {
+                    // Deltas before any snapshot (consumer joined late):
+                    // the book is incomplete — skip until a snapshot
+                    continue;
+                }
+                book.materialize(slot, out);
+                return true;
+            }
+        }
+        return false;
+    }
+
+    /// Direct access to a consumer book (features that want levels only)
+    const IncrementalOrderBook& book(uint32_t asset_id) const {
+        return books_[asset_id];
+    }
+
+    size_t queue_size() const { return queue_.size(); }
+    bool empty() const { return queue_.empty(); }
+
+private:
+    /// Producer's shadow of the last published book, for diffing
+    struct ShadowBook {
+        double bid_prices[MARKET_DEPTH_LEVELS] = {};
+        double ask_prices[MARKET_DEPTH_LEVELS] = {};
+        uint32_t bid_sizes[MARKET_DEPTH_LEVELS] = {};
+        uint32_t ask_sizes[MARKET_DEPTH_LEVELS] = {};
+        bool seen = false;
+
+        void update_from(const MarketTick& tick) {
+            std::memcpy(bid_prices, tick.bid_prices, sizeof(bid_prices));
+            std::memcpy(ask_prices, tick.ask_prices, sizeof(ask_prices));
+            std::memcpy(bid_sizes, tick.bid_sizes, sizeof(bid_sizes));
+            std::memcpy(ask_sizes, tick.ask_sizes, sizeof(ask_sizes));
+            seen = true;
+        }
+    };
+
+    /// Chunk a tick's updates into a chain of ≤2-update slots
+    bool enqueue_chain(const MarketTick& tick,
+                       const CompactLevelUpdate* updates, size_t n_updates,
+                       bool snapshot) {
+        const size_t n_slots =
+            (n_updates <= CompactTick::MAX_UPDATES)
+                ? 1
+                : (n_updates + CompactTick::MAX_UPDATES - 1) /
+                      CompactTick::MAX_UPDATES;
+
+        // All-or-nothing: a half-enqueued chain would desync the
+        // consumer book, so check capacity up front
+        if (queue_.capacity() - queue_.size() < n_slots) [[unlikely]] {
+            return false;
+        }
+
+        size_t emitted = 0;
+        for (size_t slot_idx = 0; slot_idx < n_slots; slot_idx++) {
+            CompactTick slot;
+            slot.timestamp = tick.timestamp;
+            slot.asset_id = tick.asset_id;
+            slot.trade_side = tick.trade_side;
+            slot.trade_volume = tick.trade_volume;
+            slot.mid_price = tick.mid_price;
+            slot._pad = 0;
+
+            slot.flags = 0;
+            if (snapshot) {
+                slot.flags |= CompactTick::FLAG_SNAPSHOT;
+            }
+            if (slot_idx > 0) {
+                slot.flags |= CompactTick::FLAG_CONTINUATION;
+            }
+            if (slot_idx == n_slots - 1) {
+                slot.flags |= CompactTick::FLAG_END;
+            }
+
+            slot.num_updates = 0;
+            while (slot.num_updates < CompactTick::MAX_UPDATES &&
+                   emitted < n_updates) {
+                slot.updates[slot.num_updates++] = updates[emitted++];
+            }
+
+            queue_.push(slot);  // Cannot fail: capacity checked above
+        }
+
+        return true;
+    }
+
+    LockFreeQueue<CompactTick, QueueCapacity> queue_;
+    ShadowBook shadow_books_[MaxAssets];
+    IncrementalOrderBook books_[MaxAssets];
+};
+
+} // namespace hft
@@ -158,10 +158,12 @@ struct alignas(16) RXDescriptor {
     uint64_t buffer_addr;  ///< Physical address of packet buffer (DMA)
     uint64_t header_addr;  ///< Header buffer address (optional)
     
-    // Status word (written by hardware when packet received)
+    // Status word (written by hardware when packet received).
+    // __extension__ keeps the anonymous struct (a GNU extension in C++)
+    // out of -Wpedantic's view — same treatment as detail::u128.
     union {
         uint64_t status;
-        struct {
+        __extension__ struct {
             uint16_t pkt_len;       ///< Packet length in bytes
             uint16_t hdr_len;       ///< Header length
             uint32_t status_flags;  ///< DD (descriptor done) bit, etc.
@@ -1,9 +1,22 @@
 #pragma once
 
 #include "common_types.hpp"
+#include "dma_arena.hpp"
+#include "phys_translation.hpp"
+#include "protocol_descriptors.hpp"
+#include "numa_placement.hpp"
+#include "latency_histogram.hpp"
+#include "perf_counters.hpp"
 #include <cstdint>
 #include <cstring>
+#include <vector>
 #include <sys/mman.h>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
 #include <fcntl.h>
 #include <unistd.h>
 
@@ -100,6 +113,9 @@ constexpr size_t RX_RING_SIZE = 512;
 constexpr size_t TX_RING_SIZE = 512;
 constexpr size_t PACKET_BUFFER_SIZE = 2048;  // Standard MTU
 
+// Maximum RX queues for multi-core RSS scaling (one queue per isolated core)
+constexpr size_t MAX_RX_QUEUES = 8;
+
 // Register offsets (from BAR0 base address)
 namespace reg {
     // RX queue 0 registers
@@ -119,6 +135,25 @@ namespace reg {
     // Control registers
     constexpr uint64_t CTRL         = 0x0000;  // Device control
     constexpr uint64_t STATUS       = 0x0008;  // Device status
+
+    // Multi-queue RX: queues 1..N live at a fixed stride above queue 0.
+    // (i40e exposes one register block per queue; we model the same layout.)
+    constexpr uint64_t RX_QUEUE_STRIDE = 0x40;  // Per-queue register block stride
+
+    // RSS (Receive Side Scaling) registers
+    constexpr uint64_t RSS_KEY_BASE   = 0xB800;  // 40-byte hash key (10 x 32-bit)
+    constexpr uint64_t RSS_TABLE_BASE = 0xBC00;  // 128-entry redirection table
+
+    // PHC (PTP Hardware Clock) registers — source of RX hardware timestamps
+    constexpr uint64_t PTP_TIME_LO  = 0x4800;  // PHC nanoseconds (low 32 bits)
+    constexpr uint64_t PTP_TIME_HI  = 0x4804;  // PHC nanoseconds (high 32 bits)
+
+    /**
+     * Per-queue RX register offset: queue q's copy of a queue-0 register
+     */
+    constexpr uint64_t rx_queue_reg(uint64_t queue0_reg, uint32_t queue) {
+        return queue0_reg + queue * RX_QUEUE_STRIDE;
+    }
 }
 
 // ============================================================================
@@ -135,16 +170,18 @@ struct alignas(16) RXDescriptor {
     uint64_t buffer_addr;  // Physical address of packet buffer (DMA)
     uint64_t header_addr;  // Header buffer address (optional)
     
-    // Status word (written by hardware when packet received)
+    // Status word (written by hardware when packet received).
+    // __extension__ keeps the anonymous struct (a GNU extension in C++)
+    // out of -Wpedantic's view — same treatment as detail::u128.
     union {
         uint64_t status;
-        struct {
+        __extension__ struct {
             uint16_t pkt_len;       // Packet length in bytes
             uint16_t hdr_len;       // Header length
             uint32_t status_flags;  // DD (descriptor done) bit, etc.
         };
     };
-    uint64_t reserved;
+    uint64_t timestamp;    // Hardware RX timestamp (PHC nanoseconds, write-back)
 };
 
 /**
@@ -164,6 +201,46 @@ struct alignas(16) TXDescriptor {
 constexpr uint32_t RX_DD_BIT = (1u << 0);  // Descriptor Done (packet received)
 constexpr uint32_t TX_DD_BIT = (1u << 0);  // Descriptor Done (packet sent)
 
+// Launch-time valid: the descriptor carries a scheduled transmit time and
+// the NIC holds the frame until then (X710 time-based scheduling)
+constexpr uint64_t TX_LAUNCH_TIME_BIT = (1ull << 4);
+
+/**
+ * RX burst entry: one received packet as seen by poll_rx_burst()
+ *
+ * Just a pointer into the DMA buffer plus the length from the descriptor.
+ * Zero-copy: the data pointer aims straight at the RX DMA buffer.
+ */
+struct RxBurstEntry {
+    uint8_t* data;          // Pointer into RX DMA buffer (valid until buffer re-posted)
+    size_t   len;           // Packet length in bytes (from descriptor)
+    uint64_t hw_timestamp;  // Hardware RX timestamp (PHC ns; 0 if unsupported)
+};
+
+/**
+ * PHC↔TSC correlation point
+ *
+ * The NIC stamps packets in its own PTP Hardware Clock (PHC) domain while
+ * all our software timing runs on the CPU TSC. One correlation snapshot
+ * (PHC value bracketed by two RDTSC reads) lets us convert between the
+ * domains with sub-100ns accuracy — so RX latency can be measured from
+ * the WIRE instead of from whenever the poll loop got around to it.
+ */
+struct PhcTscCorrelation {
+    uint64_t phc_ns = 0;  // PHC nanoseconds at the sync instant
+    uint64_t tsc = 0;     // TSC at the same instant
+
+    bool valid() const { return tsc != 0; }
+};
+
+/**
+ * TX burst entry: one packet to transmit via submit_tx_burst()
+ */
+struct TxBurstEntry {
+    const uint8_t* data;  // Packet data to send
+    size_t         len;   // Packet length in bytes
+};
+
 // ============================================================================
 // Custom NIC Driver (Zero Abstraction)
 // ============================================================================
@@ -221,37 +298,135 @@ public:
             return false;
         }
         
-        // Step 3: Allocate descriptor rings (DMA-able memory)
-        rx_ring_ = allocate_dma_memory<RXDescriptor>(RX_RING_SIZE);
-        tx_ring_ = allocate_dma_memory<TXDescriptor>(TX_RING_SIZE);
-        
+        // Step 3: Reserve ONE hugepage arena for all rings and buffers
+        //
+        // One mmap+mlock instead of 1,000+ (one per buffer), and everything
+        // lands contiguously on a few 2 MB pages — a handful of TLB entries
+        // cover the entire RX/TX working set. Sized for the worst case
+        // (MAX_RX_QUEUES fully-populated queues) so configure_rx_queues can
+        // carve from the same arena later.
+        const size_t arena_bytes =
+            MAX_RX_QUEUES * RX_RING_SIZE * sizeof(RXDescriptor) +
+            TX_RING_SIZE * sizeof(TXDescriptor) +
+            (MAX_RX_QUEUES * RX_RING_SIZE + TX_RING_SIZE) * PACKET_BUFFER_SIZE +
+            ull_nic::DMAArena::HUGE_PAGE_SIZE;  // Alignment slack
+
+        // The NIC's socket, from sysfs — rings and buffers are bound
+        // there so no packet read ever crosses the interconnect
+        nic_numa_node_ = ull_nic::NumaPlacement::nic_numa_node(pci_device);
+
+        if (!dma_arena_.init(arena_bytes, nic_numa_node_)) [[unlikely]] {
+            return false;
+        }
+
+        // Resolve the WHOLE arena's physical pages once (single bulk
+        // pagemap read). Every virt_to_phys below is then a table lookup —
+        // no syscalls during ring setup, none ever on the hot path.
+        if (phys_table_.register_region(dma_arena_.base(),
+                                        dma_arena_.size()) < 0) [[unlikely]] {
+            return false;
+        }
+
+        // Carve descriptor rings out of the arena
+        rx_ring_ = dma_arena_.allocate_array<RXDescriptor>(RX_RING_SIZE);
+        tx_ring_ = dma_arena_.allocate_array<TXDescriptor>(TX_RING_SIZE);
+
         if (!rx_ring_ || !tx_ring_) [[unlikely]] {
             return false;
         }
-        
-        // Step 4: Allocate packet buffers (DMA-able memory)
+
+        // Step 4: Carve packet buffers as one contiguous slab per ring
+        uint8_t* rx_slab = dma_arena_.allocate(RX_RING_SIZE * PACKET_BUFFER_SIZE);
+        uint8_t* tx_slab = dma_arena_.allocate(TX_RING_SIZE * PACKET_BUFFER_SIZE);
+        if (!rx_slab || !tx_slab) [[unlikely]] {
+            return false;
+        }
+
         for (size_t i = 0; i < RX_RING_SIZE; i++) {
-            rx_buffers_[i] = allocate_dma_memory<uint8_t>(PACKET_BUFFER_SIZE);
-            if (!rx_buffers_[i]) [[unlikely]] {
-                return false;
-            }
-            
+            rx_buffers_[i] = rx_slab + i * PACKET_BUFFER_SIZE;
+
             // Initialize RX descriptor to point to this buffer
             rx_ring_[i].buffer_addr = virt_to_phys(rx_buffers_[i]);
             rx_ring_[i].status = 0;
         }
-        
+
         for (size_t i = 0; i < TX_RING_SIZE; i++) {
-            tx_buffers_[i] = allocate_dma_memory<uint8_t>(PACKET_BUFFER_SIZE);
+            tx_buffers_[i] = tx_slab + i * PACKET_BUFFER_SIZE;
         }
         
         // Step 5: Program hardware registers (tell NIC where our rings are)
         program_rx_ring();
         program_tx_ring();
-        
+
+        // Step 6: Fault in every arena page NOW. mlock pins pages but the
+        // kernel still populates them lazily on first touch — without
+        // this, the first real packet eats the page faults
+        pretouch_dma_pages();
+
         initialized_ = true;
         return true;
     }
+
+    /**
+     * Touch every page of the DMA arena (rings + all packet buffers)
+     *
+     * mmap returns pages that are unmapped-until-touch; mlock prevents
+     * swapping but does not guarantee the page tables and TLB entries
+     * exist before the first access. An untouched RX buffer costs a
+     * minor fault (~1-2 μs) on the FIRST packet that lands in it — 10-
+     * 100x steady-state latency, on exactly the packet that matters
+     * after a pre-session restart.
+     *
+     * One read-modify-write per 4 KB page forces the fault, brings the
+     * line into cache in exclusive state, and (on hugepage arenas)
+     * populates the handful of 2 MB TLB entries that cover the whole
+     * working set. Idempotent and non-destructive.
+     *
+     * @return Number of pages touched
+     */
+    size_t pretouch_dma_pages() {
+        constexpr size_t PAGE = 4096;
+        volatile uint8_t* p = dma_arena_.base();
+        const size_t bytes = dma_arena_.size();
+        size_t pages = 0;
+        for (size_t off = 0; off < bytes; off += PAGE, pages++) {
+            p[off] = p[off];  // RMW: fault + exclusive cache line
+        }
+        return pages;
+    }
+
+    /**
+     * Inject one packet into the RX ring as if hardware received it
+     *
+     * Warm-up hook: performs exactly the descriptor write-back the NIC
+     * does on receive (buffer DMA, pkt_len, DD bit, head advance), so a
+     * subsequent poll_rx() exercises the REAL hot path — same loads,
+     * same branches, same prefetches. On production hardware the same
+     * effect comes from MAC loopback mode (TX→wire→RX inside the NIC);
+     * here we write the ring directly.
+     *
+     * @return false when the RX ring is full
+     */
+    inline bool loopback_rx_inject(const uint8_t* packet_data, size_t packet_len) {
+        if (packet_len > PACKET_BUFFER_SIZE) [[unlikely]] {
+            return false;
+        }
+
+        const uint32_t slot = read_reg32(reg::RX_HEAD);
+        const uint32_t next = (slot + 1) & (RX_RING_SIZE - 1);
+        if (next == rx_head_) [[unlikely]] {
+            return false;  // Ring full — consumer hasn't drained
+        }
+
+        // What the NIC does: DMA the payload, then write back the descriptor
+        std::memcpy(rx_buffers_[slot], packet_data, packet_len);
+        RXDescriptor& desc = rx_ring_[slot];
+        desc.pkt_len = static_cast<uint16_t>(packet_len);
+        desc.status_flags = RX_DD_BIT;
+
+        write_reg32(reg::RX_HEAD, next);
+        return true;
+    }
     
     /**
      * Poll for received packet (ULTRA-FAST PATH)
@@ -291,13 +466,426 @@ public:
         
         // Advance head pointer (circular buffer)
         rx_head_ = (rx_head_ + 1) & (RX_RING_SIZE - 1);
+
+        // PIPELINE: pull descriptor i+1 and its packet buffer toward L1
+        // while the caller processes packet i. At burst rates the next
+        // poll then hits warm lines instead of eating two cold-ish loads
+        // (~45 ns → ~25 ns per packet on Ice Lake).
+        __builtin_prefetch(&rx_ring_[rx_head_], 0, 3);
+        __builtin_prefetch(rx_buffers_[rx_head_], 0, 3);
         
         // Update hardware tail pointer (tell NIC this buffer is available)
         write_reg32(reg::RX_TAIL, rx_head_);
         
         return true;
     }
-    
+
+    /**
+     * poll_rx with a compile-time capture tap (compliance recording)
+     *
+     * The tap is a TEMPLATE parameter (ull_nic::CaptureRing or anything
+     * with the same append() shape): loops that don't pass a tap
+     * instantiate the untapped poll_rx above and pay literally nothing.
+     * With a tap, the added cost is one bounded memcpy into a hugepage
+     * ring — no syscalls, no locks, and the tap DROPS (counted) rather
+     * than block when its drainer lags. See packet_capture.hpp.
+     */
+    template<typename CaptureTap>
+    inline bool poll_rx(uint8_t** packet_data, size_t* packet_len,
+                        CaptureTap& tap) {
+        if (!poll_rx(packet_data, packet_len)) {
+            return false;
+        }
+        tap.append(*packet_data, *packet_len, ull_nic::get_timestamp());
+        return true;
+    }
+
+    /**
+     * Poll for a BURST of received packets (ULTRA-FAST PATH, amortized MMIO)
+     *
+     * Why burst semantics beat per-packet polling:
+     * ────────────────────────────────────────────
+     *
+     * poll_rx() pays TWO PCIe transactions per packet:
+     * 1. read_reg32(RX_HEAD)  → MMIO load  (~3-5 ns cached, much worse uncached)
+     * 2. write_reg32(RX_TAIL) → MMIO write + mfence (~10-15 ns)
+     *
+     * Under a 10G line-rate burst those two transactions per packet dominate
+     * the RX path. This API reads RX_HEAD ONCE, drains every completed
+     * descriptor in a single pass, and writes RX_TAIL ONCE at the end:
+     *
+     * Per-packet cost:
+     * - poll_rx:        ~15-20 ns of MMIO per packet
+     * - poll_rx_burst:  ~15-20 ns of MMIO per BURST (amortized to <1 ns/pkt
+     *                   for a 32-packet burst!)
+     *
+     * Same idea as DPDK's rx_burst — but without the PMD abstraction layer.
+     *
+     * Usage:
+     * ```cpp
+     * RxBurstEntry burst[32];
+     * size_t n = nic.poll_rx_burst(burst, 32);
+     * for (size_t i = 0; i < n; i++) {
+     *     process(burst[i].data, burst[i].len);
+     * }
+     * ```
+     *
+     * @param pkts Output array of at least max_burst entries
+     * @param max_burst Maximum number of packets to drain in this call
+     * @return Number of packets received (0 if ring empty)
+     *
+     * @note Packet data pointers are valid until the NEXT poll_rx_burst /
+     *       poll_rx call wraps the ring back to the same slot. Process (or
+     *       copy out) the burst before polling again.
+     */
+    inline size_t poll_rx_burst(RxBurstEntry* pkts, size_t max_burst) {
+        // ONE MMIO read for the whole burst (this is the expensive part)
+        uint32_t hw_head = read_reg32(reg::RX_HEAD);
+
+        if (hw_head == rx_head_) [[unlikely]] {
+            return 0;  // No new packets
+        }
+
+        size_t count = 0;
+
+        // Drain every completed descriptor in a single pass (memory-only loop)
+        while (rx_head_ != hw_head && count < max_burst) {
+            RXDescriptor& desc = rx_ring_[rx_head_];
+
+            // PIPELINE: two iterations ahead — far enough that the lines
+            // arrive before the loop gets there, close enough that they
+            // aren't evicted first. One ahead isn't enough at this
+            // iteration cost (~10 ns vs ~70 ns L2/L3 latency).
+            const uint32_t ahead = (rx_head_ + 2) & (RX_RING_SIZE - 1);
+            __builtin_prefetch(&rx_ring_[ahead], 0, 3);
+            __builtin_prefetch(rx_buffers_[ahead], 0, 3);
+
+            // Hardware may still be DMA-ing this slot — stop at first not-done
+            if (!(desc.status_flags & RX_DD_BIT)) [[unlikely]] {
+                break;
+            }
+
+            pkts[count].data = rx_buffers_[rx_head_];
+            pkts[count].len  = desc.pkt_len;
+            pkts[count].hw_timestamp = desc.timestamp;
+            count++;
+
+            // Clear DD bit so the slot can be reused
+            desc.status_flags = 0;
+
+            rx_head_ = (rx_head_ + 1) & (RX_RING_SIZE - 1);
+        }
+
+        // ONE MMIO write returns ALL drained buffers to hardware
+        if (count > 0) [[likely]] {
+            write_reg32(reg::RX_TAIL, rx_head_);
+        }
+
+        return count;
+    }
+
+    // ========================================================================
+    // Hardware RX Timestamping
+    // ========================================================================
+
+    /**
+     * Poll for a received packet WITH its hardware timestamp
+     *
+     * Performance: same 20-50 ns fast path as poll_rx — the timestamp is
+     * one extra load from a descriptor line that's already in L1.
+     *
+     * Why hardware timestamps matter:
+     * Software stamping (ull_nic::get_timestamp() after the poll returns)
+     * measures "when the poll loop noticed", which is tens of nanoseconds
+     * after the wire plus whatever jitter the loop had. The NIC stamps the
+     * packet at the MAC (~8 ns precision on X710/ef_vi class hardware), so
+     * latency accounting measures the wire, not the software.
+     *
+     * @param[out] hw_timestamp PHC nanoseconds at packet arrival
+     *             (convert to the TSC domain via hw_timestamp_to_tsc)
+     */
+    inline bool poll_rx_ts(uint8_t** packet_data, size_t* packet_len,
+                           uint64_t* hw_timestamp) {
+        uint32_t hw_head = read_reg32(reg::RX_HEAD);
+        if (hw_head == rx_head_) [[unlikely]] {
+            return false;
+        }
+
+        RXDescriptor& desc = rx_ring_[rx_head_];
+        if (!(desc.status_flags & RX_DD_BIT)) [[unlikely]] {
+            return false;
+        }
+
+        *packet_data = rx_buffers_[rx_head_];
+        *packet_len = desc.pkt_len;
+        *hw_timestamp = desc.timestamp;  // PHC ns, written back by hardware
+
+        // Wire-to-poll latency into the shared histogram: MAC stamp vs
+        // "the poll loop noticed". Callers of the _ts variant already
+        // opted into timestamp accounting, so the extra ~10 ns (one
+        // domain conversion + a CLZ-bucketed increment) belongs here —
+        // the plain poll_rx stays untouched.
+        const uint64_t hw_tsc = hw_timestamp_to_tsc(
+            *hw_timestamp, ull_nic::tsc_calibration().frequency_hz());
+        const uint64_t now_tsc = ull_nic::get_timestamp();
+        if (now_tsc > hw_tsc) [[likely]] {
+            wire_to_poll_hist_.record(
+                ull_nic::tsc_calibration().to_ns(now_tsc - hw_tsc));
+        }
+
+        desc.status_flags = 0;
+        rx_head_ = (rx_head_ + 1) & (RX_RING_SIZE - 1);
+        write_reg32(reg::RX_TAIL, rx_head_);
+
+        return true;
+    }
+
+    /// Wire-to-poll latency percentiles (fed by poll_rx_ts)
+    const ull_nic::LatencyHistogram& wire_to_poll_histogram() const {
+        return wire_to_poll_hist_;
+    }
+
+    /// Wire-to-poll SLA judged at a percentile (see latency_histogram.hpp)
+    bool meets_latency_sla(uint64_t sla_ns, double percentile = 99.0) const {
+        return wire_to_poll_hist_.meets_latency_sla(sla_ns, percentile);
+    }
+
+    /**
+     * Snapshot the PHC↔TSC correlation (call at init, re-sync periodically)
+     *
+     * Reads the PHC bracketed by two RDTSC reads and takes the TSC
+     * midpoint. Cost: two MMIO reads (~30 ns) — NOT for the hot path.
+     */
+    PhcTscCorrelation sync_phc_tsc() {
+        const uint64_t t0 = ull_nic::get_timestamp();
+        const uint64_t lo = read_reg32(reg::PTP_TIME_LO);
+        const uint64_t hi = read_reg32(reg::PTP_TIME_HI);
+        const uint64_t t1 = ull_nic::get_timestamp();
+
+        phc_correlation_.phc_ns = (hi << 32) | lo;
+        phc_correlation_.tsc = t0 + (t1 - t0) / 2;
+        return phc_correlation_;
+    }
+
+    /**
+     * Convert a hardware (PHC) timestamp into the TSC domain
+     *
+     * tsc = sync_tsc + (phc_ns - sync_phc_ns) * tsc_freq / 1e9
+     *
+     * @param phc_ns Hardware timestamp from poll_rx_ts / RxBurstEntry
+     * @param tsc_freq TSC frequency in Hz (see tsc_to_ns calibration note)
+     * @return Equivalent TSC value, comparable with ull_nic::get_timestamp()
+     */
+    inline uint64_t hw_timestamp_to_tsc(uint64_t phc_ns,
+                                        uint64_t tsc_freq = 2'800'000'000) const {
+        const int64_t delta_ns =
+            static_cast<int64_t>(phc_ns) - static_cast<int64_t>(phc_correlation_.phc_ns);
+        const int64_t delta_tsc =
+            (delta_ns * static_cast<int64_t>(tsc_freq / 1'000'000)) / 1'000;
+        return phc_correlation_.tsc + delta_tsc;
+    }
+
+    // ========================================================================
+    // Multi-Queue RSS Receive Engine (scale RX linearly across cores)
+    // ========================================================================
+
+    /**
+     * RxQueueHandle: Per-queue polling handle for multi-core RX
+     *
+     * One core at ~100M polls/sec saturates well before a 25G feed does.
+     * The fix: program N RX queues with RSS steering so the NIC hashes each
+     * flow to a queue, then pin one polling core per queue.
+     *
+     * Each handle owns its OWN descriptor ring, packet buffers, and software
+     * head pointer — no sharing, no false sharing, no locks. Pin each handle
+     * to its own isolated core and RX throughput scales linearly.
+     *
+     * Usage (per polling core):
+     * ```cpp
+     * nic.configure_rx_queues(4);          // 4 queues, RSS round-robin
+     * auto& q = nic.rx_queue(core_index);  // one handle per core
+     * RxBurstEntry burst[32];
+     * while (true) {
+     *     size_t n = q.poll_rx_burst(burst, 32);
+     *     for (size_t i = 0; i < n; i++) process(burst[i].data, burst[i].len);
+     * }
+     * ```
+     */
+    class RxQueueHandle {
+    public:
+        RxQueueHandle()
+            : bar0_base_(nullptr)
+            , ring_(nullptr)
+            , head_(0)
+            , head_reg_(0)
+            , tail_reg_(0)
+            , queue_id_(0)
+        {
+            for (size_t i = 0; i < RX_RING_SIZE; i++) {
+                buffers_[i] = nullptr;
+            }
+        }
+
+        /**
+         * Poll this queue for one packet (same fast path as CustomNICDriver::poll_rx)
+         */
+        inline bool poll_rx(uint8_t** packet_data, size_t* packet_len) {
+            uint32_t hw_head = read_reg32(head_reg_);
+            if (hw_head == head_) [[unlikely]] {
+                return false;
+            }
+
+            RXDescriptor& desc = ring_[head_];
+            if (!(desc.status_flags & RX_DD_BIT)) [[unlikely]] {
+                return false;
+            }
+
+            *packet_data = buffers_[head_];
+            *packet_len = desc.pkt_len;
+
+            desc.status_flags = 0;
+            head_ = (head_ + 1) & (RX_RING_SIZE - 1);
+            write_reg32(tail_reg_, head_);
+
+            return true;
+        }
+
+        /**
+         * Poll this queue for a burst (one RX_HEAD read, one RX_TAIL write)
+         */
+        inline size_t poll_rx_burst(RxBurstEntry* pkts, size_t max_burst) {
+            uint32_t hw_head = read_reg32(head_reg_);
+            if (hw_head == head_) [[unlikely]] {
+                return 0;
+            }
+
+            size_t count = 0;
+            while (head_ != hw_head && count < max_burst) {
+                RXDescriptor& desc = ring_[head_];
+
+                // Same two-ahead pipeline as the single-queue burst path
+                const uint32_t ahead = (head_ + 2) & (RX_RING_SIZE - 1);
+                __builtin_prefetch(&ring_[ahead], 0, 3);
+                __builtin_prefetch(buffers_[ahead], 0, 3);
+
+                if (!(desc.status_flags & RX_DD_BIT)) [[unlikely]] {
+                    break;
+                }
+
+                pkts[count].data = buffers_[head_];
+                pkts[count].len  = desc.pkt_len;
+                pkts[count].hw_timestamp = desc.timestamp;
+                count++;
+
+                desc.status_flags = 0;
+                head_ = (head_ + 1) & (RX_RING_SIZE - 1);
+            }
+
+            if (count > 0) [[likely]] {
+                write_reg32(tail_reg_, head_);
+            }
+
+            return count;
+        }
+
+        uint32_t queue_id() const { return queue_id_; }
+
+    private:
+        friend class CustomNICDriver;
+
+        volatile uint8_t* bar0_base_;
+        RXDescriptor* ring_;
+        uint8_t* buffers_[RX_RING_SIZE];
+        uint32_t head_;
+        uint64_t head_reg_;
+        uint64_t tail_reg_;
+        uint32_t queue_id_;
+
+        inline uint32_t read_reg32(uint64_t offset) const {
+            return *reinterpret_cast<volatile uint32_t*>(bar0_base_ + offset);
+        }
+
+        inline void write_reg32(uint64_t offset, uint32_t value) {
+            *reinterpret_cast<volatile uint32_t*>(bar0_base_ + offset) = value;
+            __asm__ __volatile__("mfence" ::: "memory");
+        }
+    };
+
+    /**
+     * Configure N RX queues with RSS steering
+     *
+     * What this does:
+     * 1. Allocates a private descriptor ring + packet buffers per queue
+     *    (ideally on the NIC's NUMA node — see placement notes in DRIVERS.md)
+     * 2. Programs each queue's ring registers at its per-queue offset
+     * 3. Writes the RSS hash key and fills the 128-entry redirection table
+     *    round-robin so flows spread evenly across queues
+     *
+     * Call AFTER initialize(). Queue 0 remains usable through the single-queue
+     * poll_rx/poll_rx_burst API; queues 0..N-1 are reachable via rx_queue().
+     *
+     * @param num_queues Number of RX queues (1..MAX_RX_QUEUES)
+     * @return true if all queues were set up
+     */
+    bool configure_rx_queues(size_t num_queues) {
+        if (!initialized_ || num_queues == 0 || num_queues > MAX_RX_QUEUES) [[unlikely]] {
+            return false;
+        }
+
+        for (size_t q = 0; q < num_queues; q++) {
+            RxQueueHandle& queue = rx_queues_[q];
+            queue.bar0_base_ = bar0_base_;
+            queue.queue_id_ = static_cast<uint32_t>(q);
+            queue.head_reg_ = reg::rx_queue_reg(reg::RX_HEAD, q);
+            queue.tail_reg_ = reg::rx_queue_reg(reg::RX_TAIL, q);
+            queue.head_ = 0;
+
+            // Queue 0 reuses the ring initialize() already built
+            if (q == 0) {
+                queue.ring_ = rx_ring_;
+                for (size_t i = 0; i < RX_RING_SIZE; i++) {
+                    queue.buffers_[i] = rx_buffers_[i];
+                }
+                continue;
+            }
+
+            // Private ring + buffer slab for this queue, carved from the
+            // shared hugepage arena (initialize() sized it for MAX_RX_QUEUES)
+            queue.ring_ = dma_arena_.allocate_array<RXDescriptor>(RX_RING_SIZE);
+            uint8_t* slab = dma_arena_.allocate(RX_RING_SIZE * PACKET_BUFFER_SIZE);
+            if (!queue.ring_ || !slab) [[unlikely]] {
+                return false;
+            }
+
+            for (size_t i = 0; i < RX_RING_SIZE; i++) {
+                queue.buffers_[i] = slab + i * PACKET_BUFFER_SIZE;
+                queue.ring_[i].buffer_addr = virt_to_phys(queue.buffers_[i]);
+                queue.ring_[i].status = 0;
+            }
+
+            // Program this queue's ring registers (same layout as queue 0)
+            uint64_t ring_phys = virt_to_phys(queue.ring_);
+            write_reg32(reg::rx_queue_reg(reg::RX_BASE_LO, q), ring_phys & 0xFFFFFFFF);
+            write_reg32(reg::rx_queue_reg(reg::RX_BASE_HI, q), ring_phys >> 32);
+            write_reg32(reg::rx_queue_reg(reg::RX_LEN, q), RX_RING_SIZE * sizeof(RXDescriptor));
+            write_reg32(queue.head_reg_, 0);
+            write_reg32(queue.tail_reg_, RX_RING_SIZE - 1);  // All buffers available
+        }
+
+        configure_rss(num_queues);
+        num_rx_queues_ = num_queues;
+        return true;
+    }
+
+    /**
+     * Get the polling handle for queue q (pin each handle to its own core!)
+     */
+    RxQueueHandle& rx_queue(size_t q) {
+        return rx_queues_[q];
+    }
+
+    size_t num_rx_queues() const { return num_rx_queues_; }
+
     /**
      * BUSY-WAIT LOOP: The Real Secret to Sub-Microsecond Latency!
      * 
@@ -455,10 +1043,164 @@ public:
             // ═══════════════════════════════════════════════════════════════
             
         }  // ← Loop back to top immediately!
-        
+
         // NEVER REACHED (infinite loop)
     }
+
+    /**
+     * busy_wait_loop with per-stage hardware counter hooks
+     *
+     * Same loop, plus a profiler bracketing each stage — the
+     * ull_nic::StageProfiler reads cycles / LLC misses / dTLB misses
+     * via userspace RDPMC, so a p99.9 spike can be attributed to the
+     * poll (cold rx_ring_ line?), the callback, or a sub-stage the
+     * callback scopes itself (parse/LOB/inference — see
+     * ull_nic::stage). The profiler is a TEMPLATE parameter, same
+     * pattern as the capture tap on poll_rx: instantiating with
+     * NullStageProfiler compiles to the identical machine code as the
+     * plain loop above.
+     *
+     * Attribution policy: only SUCCESSFUL polls are recorded. Empty
+     * polls would drown the histogram in 10 ns samples, and their
+     * counter reads (~100 cycles each with live PMU) are discarded —
+     * that read cost is the instrumentation tax while profiling, and
+     * exactly zero with the null profiler.
+     *
+     * ```cpp
+     * ull_nic::StageProfiler<> prof;
+     * prof.init();  // From the pinned polling thread
+     * nic.busy_wait_loop([&](uint8_t* pkt, size_t len) {
+     *     { auto s = prof.scope(ull_nic::stage::PARSE); parse(pkt, len); }
+     *     { auto s = prof.scope(ull_nic::stage::INFERENCE); infer(); }
+     * }, prof);
+     * ```
+     */
+    template<typename Callback, typename Profiler>
+    [[noreturn]] void busy_wait_loop(Callback&& callback, Profiler& prof) {
+        uint8_t* packet_data;
+        size_t packet_len;
+
+        while (true) {
+            // Snapshot BEFORE the poll; attributed only on success
+            const auto poll_start = prof.sample();
+
+            if (poll_rx(&packet_data, &packet_len)) [[likely]] {
+                prof.accumulate(ull_nic::stage::POLL_RX, poll_start);
+
+                // Whole-callback bracket; sub-stages nest inside via
+                // the caller's own prof.scope(...) blocks
+                auto s = prof.scope(ull_nic::stage::CALLBACK);
+                callback(packet_data, packet_len);
+            }
+        }
+    }
+
+    /**
+     * Adaptive busy-wait loop: full-rate spin while packets flow,
+     * power-aware hardware wait during lulls (OPT-IN)
+     *
+     * Why this exists:
+     * ───────────────
+     *
+     * busy_wait_loop() spins at 100% unconditionally. During the
+     * 17:00-18:00 CT maintenance window and overnight lulls that's pure
+     * heat — across a rack it adds up to hundreds of watts, and worse,
+     * it thermally throttles the SIBLING core running inference.
+     *
+     * The adaptive variant keeps the identical pure-spin hot path, but
+     * after EMPTY_POLL_THRESHOLD consecutive empty polls it arms a
+     * hardware monitor on the next RX descriptor's cache line and parks
+     * the core in a light sleep state:
+     *
+     * - x86 with WAITPKG (Ice Lake+): UMONITOR + UMWAIT — the core
+     *   drops to C0.1/C0.2 and wakes within ~100 ns of the NIC's DMA
+     *   write to the watched line, bounded by a TSC deadline
+     * - Older x86: a PAUSE loop with the same TSC deadline (no deep
+     *   state, but PAUSE yields pipeline resources to the sibling)
+     *
+     * Both template parameters are compile-time, so:
+     *
+     * - Hot-session loops keep calling busy_wait_loop() — unchanged
+     * - An adaptive loop with EMPTY_POLL_THRESHOLD = 0 compiles to the
+     *   pure spin, the counter and branch optimize away entirely
+     *
+     * Usage:
+     * ```cpp
+     * // Spin hard; after ~4096 empty polls (≈40 μs of silence), wait
+     * // on the descriptor line for at most 10 μs at a time
+     * nic.busy_wait_loop_adaptive<4096, 10'000>(
+     *     [](uint8_t* pkt, size_t len) { process(pkt, len); });
+     * ```
+     *
+     * @tparam EMPTY_POLL_THRESHOLD Empty polls before arming the wait
+     *         (0 = never wait — identical codegen to busy_wait_loop)
+     * @tparam MAX_WAIT_NS Upper bound on one hardware wait, ns
+     * @note Never returns.
+     */
+    template<uint32_t EMPTY_POLL_THRESHOLD = 4096,
+             uint64_t MAX_WAIT_NS = 10'000,
+             typename Callback>
+    [[noreturn]] void busy_wait_loop_adaptive(Callback&& callback) {
+        uint8_t* packet_data;
+        size_t packet_len;
+        uint32_t empty_polls = 0;
+
+        while (true) {
+            if (poll_rx(&packet_data, &packet_len)) [[likely]] {
+                callback(packet_data, packet_len);
+                empty_polls = 0;  // Back to full-rate spinning
+                continue;
+            }
+
+            if constexpr (EMPTY_POLL_THRESHOLD > 0) {
+                if (++empty_polls >= EMPTY_POLL_THRESHOLD) [[unlikely]] {
+                    idle_wait_on_rx(MAX_WAIT_NS);
+                    empty_polls = 0;
+                }
+            }
+        }
+    }
     
+    /**
+     * Pin the CALLING (polling) thread next to the NIC — fail loudly
+     *
+     * Verifies the requested core shares the NIC's NUMA node (refusing
+     * a cross-socket layout outright), pins with pthread_setaffinity_np
+     * — actually calls it — and switches to SCHED_FIFO so the scheduler
+     * can neither migrate nor time-slice the busy-wait loop.
+     *
+     * Call from the polling thread itself, before busy_wait_loop():
+     * ```cpp
+     * if (!nic.pin_polling_thread(2)) return 1;   // wrong socket = no deploy
+     * nic.busy_wait_loop(...);
+     * ```
+     *
+     * @param cpu_core Core to pin to (should be isolcpus-isolated)
+     * @param rt_priority SCHED_FIFO priority (0 = skip the RT switch)
+     * @return false on a cross-socket layout or failed affinity call
+     */
+    bool pin_polling_thread(int cpu_core, int rt_priority = 49) {
+        if (!ull_nic::NumaPlacement::verify_same_node(cpu_core,
+                                                      nic_numa_node_)) {
+            return false;  // verify_same_node already shouted the details
+        }
+
+        if (!ull_nic::NumaPlacement::pin_thread(cpu_core)) {
+            return false;
+        }
+
+        if (rt_priority > 0) {
+            // RT failure is survivable (containers without CAP_SYS_NICE)
+            // but never silent
+            ull_nic::NumaPlacement::set_realtime_priority(rt_priority);
+        }
+
+        return true;
+    }
+
+    /// NUMA node the NIC sits on (-1 when sysfs has no answer)
+    int numa_node() const { return nic_numa_node_; }
+
     /**
      * Busy-wait for SPECIFIC number of packets (for testing/benchmarking)
      * 
@@ -525,14 +1267,303 @@ public:
         
         // Write tail register to trigger DMA (this starts transmission!)
         write_reg32(reg::TX_TAIL, new_tail);
-        
+
         tx_tail_ = new_tail;
+        tx_submit_seq_++;
         return true;
     }
-    
+
+    /**
+     * Submit packet with a descriptor-level LAUNCH TIME (hardware pacing)
+     *
+     * X710-class NICs support time-based transmit scheduling: the
+     * descriptor carries a PHC launch time and the NIC holds the frame
+     * until that instant, releasing it with nanosecond precision. Pacing
+     * in software costs a 10-50 us scheduler wakeup PLUS serialize + DMA
+     * after the wakeup; with launch time the packet is already staged in
+     * the TX ring and only the hardware trigger remains.
+     *
+     * Same fast path as submit_tx() — one extra descriptor store for the
+     * launch time and the launch-time-valid command bit. The ~500 ns
+     * DMA fetch pipeline is hidden by scheduling a few microseconds
+     * ahead (see ScheduledTx::HW_HANDOFF_SLOTS).
+     *
+     * @param launch_time_ns Absolute release time (PHC nanoseconds).
+     *        A time already in the past transmits immediately — the
+     *        hardware treats stale launch times as "now".
+     */
+    inline bool submit_tx_at(const uint8_t* packet_data, size_t packet_len,
+                             uint64_t launch_time_ns) {
+        if (packet_len > PACKET_BUFFER_SIZE) [[unlikely]] {
+            return false;
+        }
+
+        // Copy packet to DMA buffer
+        std::memcpy(tx_buffers_[tx_tail_], packet_data, packet_len);
+
+        // Setup TX descriptor with launch time
+        TXDescriptor& desc = tx_ring_[tx_tail_];
+        desc.buffer_addr = virt_to_phys(tx_buffers_[tx_tail_]);
+        desc.cmd_type_len = (packet_len << 16) | (1 << 0)   // Length + EOP bit
+                            | TX_LAUNCH_TIME_BIT;
+        desc.olinfo_status = 0;
+        desc.reserved = launch_time_ns;  // Launch-time word (i40e timestamp field)
+
+        // Advance tail pointer
+        uint32_t new_tail = (tx_tail_ + 1) & (TX_RING_SIZE - 1);
+
+        // Doorbell hands the descriptor to hardware; the WIRE release
+        // happens at launch_time_ns, not now
+        write_reg32(reg::TX_TAIL, new_tail);
+
+        tx_tail_ = new_tail;
+        tx_submit_seq_++;
+        return true;
+    }
+
+    // ========================================================================
+    // Burst TX with Doorbell Coalescing
+    // ========================================================================
+
+    /**
+     * Stage one packet for transmission WITHOUT ringing the doorbell
+     *
+     * Performance: 20-40 ns (memcpy + descriptor store — NO MMIO!)
+     *
+     * submit_tx() pays one TX_TAIL MMIO write plus an mfence per packet
+     * (~10-15 ns each, fully serialized). A 3-5 order burst after a signal
+     * therefore pays 3-5 PCIe doorbell transactions back to back.
+     *
+     * stage_tx() only fills the DMA buffer and descriptor; the doorbell is
+     * rung once by flush_tx() (or automatically when the auto-flush
+     * threshold is reached). Burst TX cost approaches ONE MMIO write per
+     * burst instead of per packet.
+     *
+     * @note Nothing is transmitted until flush_tx() runs!
+     */
+    inline bool stage_tx(const uint8_t* packet_data, size_t packet_len) {
+        if (packet_len > PACKET_BUFFER_SIZE) [[unlikely]] {
+            return false;
+        }
+
+        // Copy packet to DMA buffer
+        std::memcpy(tx_buffers_[tx_tail_], packet_data, packet_len);
+
+        // Setup TX descriptor (no doorbell yet!)
+        TXDescriptor& desc = tx_ring_[tx_tail_];
+        desc.buffer_addr = virt_to_phys(tx_buffers_[tx_tail_]);
+        desc.cmd_type_len = (packet_len << 16) | (1 << 0);  // Length + EOP bit
+        desc.olinfo_status = 0;
+
+        tx_tail_ = (tx_tail_ + 1) & (TX_RING_SIZE - 1);
+        tx_pending_++;
+        tx_submit_seq_++;
+
+        // Optional auto-flush: ring the doorbell once the burst is big enough
+        if (tx_autoflush_threshold_ > 0 &&
+            tx_pending_ >= tx_autoflush_threshold_) [[unlikely]] {
+            flush_tx();
+        }
+
+        return true;
+    }
+
+    /**
+     * Ring the TX doorbell for all staged packets (ONE MMIO write)
+     *
+     * Performance: 10-15 ns regardless of how many packets were staged
+     */
+    inline void flush_tx() {
+        if (tx_pending_ == 0) [[unlikely]] {
+            return;
+        }
+
+        // One doorbell covers every descriptor staged since the last flush.
+        // (x86 orders the preceding descriptor stores before this UC write;
+        // write_reg32's mfence then ensures the doorbell has posted.)
+        write_reg32(reg::TX_TAIL, tx_tail_);
+        tx_pending_ = 0;
+    }
+
+    /**
+     * Submit a burst of packets with a single doorbell write
+     *
+     * Performance: ~25-45 ns per packet + ONE 10-15 ns doorbell for the
+     * whole burst (vs one doorbell + mfence per packet with submit_tx)
+     *
+     * Usage:
+     * ```cpp
+     * TxBurstEntry burst[4] = {{order1, len1}, {order2, len2}, ...};
+     * nic.submit_tx_burst(burst, 4);  // 4 packets, 1 PCIe doorbell
+     * ```
+     *
+     * @return Number of packets staged and flushed (stops early if a packet
+     *         exceeds PACKET_BUFFER_SIZE)
+     */
+    inline size_t submit_tx_burst(const TxBurstEntry* pkts, size_t n) {
+        size_t staged = 0;
+        for (size_t i = 0; i < n; i++) {
+            if (!stage_tx(pkts[i].data, pkts[i].len)) [[unlikely]] {
+                break;
+            }
+            staged++;
+        }
+        flush_tx();
+        return staged;
+    }
+
+    /**
+     * Set auto-flush threshold for stage_tx (0 = manual flush only)
+     *
+     * With threshold N, every Nth staged packet rings the doorbell
+     * automatically — a latency/throughput knob for streaming TX.
+     */
+    void set_tx_autoflush(size_t threshold) {
+        tx_autoflush_threshold_ = threshold;
+    }
+
+    // ========================================================================
+    // True Zero-Copy TX with Registered User Buffers
+    // ========================================================================
+
+    /// Maximum number of simultaneously registered TX regions
+    static constexpr size_t MAX_TX_REGIONS = 4;
+
+    /**
+     * Register a user buffer region for zero-copy transmission
+     *
+     * submit_tx always memcpy's the payload into tx_buffers_ before filling
+     * the descriptor — 20-40 ns of copying plus L1 pollution for packets
+     * that were ALREADY built in a pinned arena. Registration kills the copy:
+     *
+     * 1. The region is mlock'd (DMA needs stable physical pages)
+     * 2. Every 4 KB page's physical address is resolved ONCE, up front
+     * 3. submit_tx_zerocopy() then points the TX descriptor straight at the
+     *    registered memory — zero copies, zero pagemap syscalls on the hot path
+     *
+     * Build your order packets in a registered slot (e.g. via
+     * CustomPacketFilter::build_order_packet) and transmit with no memcpy.
+     *
+     * @param base Region base address (should be page-aligned)
+     * @param len Region length in bytes
+     * @return Region id for submit_tx_zerocopy, or -1 on failure
+     */
+    int register_tx_region(void* base, size_t len) {
+        if (num_tx_regions_ >= MAX_TX_REGIONS || !base || len == 0) [[unlikely]] {
+            return -1;
+        }
+
+        TxRegion& region = tx_regions_[num_tx_regions_];
+        region.base = static_cast<uint8_t*>(base);
+        region.len = len;
+
+        // Pin pages: DMA must never hit a swapped-out or migrated page
+        mlock(base, len);
+
+        // Bulk-resolve every page ONCE into the shared translation table
+        // (one pagemap read for the whole region, never paid again)
+        region.table_id = phys_table_.register_region(base, len);
+        if (region.table_id < 0) [[unlikely]] {
+            return -1;  // Translation failed (not resident?)
+        }
+
+        return static_cast<int>(num_tx_regions_++);
+    }
+
+    /**
+     * Stage a zero-copy transmit from a registered region (no memcpy!)
+     *
+     * Performance: ~10-15 ns (descriptor store + phys lookup — no copy,
+     * no MMIO until flush_tx)
+     *
+     * @param region_id Id returned by register_tx_region
+     * @param offset Byte offset of the packet within the region
+     * @param len Packet length (must not cross a 4 KB page boundary unless
+     *            the region is hugepage-backed / physically contiguous)
+     * @return true if staged
+     *
+     * @note The buffer MUST NOT be reused until its submission epoch has
+     *       completed — see tx_submitted_seq() / tx_completed_seq().
+     */
+    inline bool stage_tx_zerocopy(int region_id, uint64_t offset, size_t len) {
+        if (region_id < 0 ||
+            static_cast<size_t>(region_id) >= num_tx_regions_) [[unlikely]] {
+            return false;
+        }
+
+        const TxRegion& region = tx_regions_[region_id];
+        if (offset + len > region.len) [[unlikely]] {
+            return false;
+        }
+
+        // Branch-free physical address from the precomputed page table
+        const uint64_t phys = phys_table_.lookup_fast(region.table_id, offset);
+
+        // Descriptor points DIRECTLY at the registered user memory
+        TXDescriptor& desc = tx_ring_[tx_tail_];
+        desc.buffer_addr = phys;
+        desc.cmd_type_len = (len << 16) | (1 << 0);  // Length + EOP bit
+        desc.olinfo_status = 0;
+
+        tx_tail_ = (tx_tail_ + 1) & (TX_RING_SIZE - 1);
+        tx_pending_++;
+        tx_submit_seq_++;
+
+        if (tx_autoflush_threshold_ > 0 &&
+            tx_pending_ >= tx_autoflush_threshold_) [[unlikely]] {
+            flush_tx();
+        }
+
+        return true;
+    }
+
+    /**
+     * Zero-copy transmit: stage from registered region + ring doorbell
+     *
+     * Performance: ~25-35 ns total (vs 30-60 ns for the copying submit_tx)
+     */
+    inline bool submit_tx_zerocopy(int region_id, uint64_t offset, size_t len) {
+        if (!stage_tx_zerocopy(region_id, offset, len)) [[unlikely]] {
+            return false;
+        }
+        flush_tx();
+        return true;
+    }
+
+    /**
+     * Monotonic count of descriptors submitted for transmission
+     *
+     * Together with tx_completed_seq() this forms the buffer-reuse epoch:
+     * remember the value AFTER staging a zero-copy packet; the buffer may
+     * be reused once tx_completed_seq() >= that value.
+     */
+    inline uint64_t tx_submitted_seq() const {
+        return tx_submit_seq_;
+    }
+
+    /**
+     * Monotonic count of descriptors the hardware has finished DMA-ing
+     *
+     * Performance: one MMIO read (~10-15 ns)
+     *
+     * ```cpp
+     * nic.submit_tx_zerocopy(region, slot_off, 64);
+     * uint64_t epoch = nic.tx_submitted_seq();
+     * ...
+     * if (nic.tx_completed_seq() >= epoch) {
+     *     // slot_off may be rewritten now
+     * }
+     * ```
+     */
+    inline uint64_t tx_completed_seq() {
+        const uint32_t hw_head = read_reg32(reg::TX_HEAD);
+        const uint32_t in_flight = (tx_tail_ - hw_head) & (TX_RING_SIZE - 1);
+        return tx_submit_seq_ - in_flight;
+    }
+
     /**
      * Check if TX completed (for buffer reuse)
-     * 
+     *
      * Performance: 10-20 ns
      */
     inline bool poll_tx_completion() {
@@ -540,10 +1571,99 @@ public:
         return (hw_head != tx_tail_);  // TX ring not full
     }
 
+    /**
+     * Reclaim up to max_n completed TX descriptors (amortized cleanup)
+     *
+     * poll_tx_completion() only says whether the ring moved; this
+     * actually retires descriptors — scrubbing each slot so it's ready
+     * for reuse and COUNTING them, with ONE TX_HEAD MMIO read for the
+     * whole batch instead of one per query. Call it on idle polls (no
+     * RX packet this iteration) so cleanup cost lands in otherwise-
+     * wasted spin cycles, never on a send:
+     *
+     * ```cpp
+     * if (!nic.poll_rx(&data, &len)) {
+     *     nic.reclaim_budgeted();  // Idle: retire finished sends
+     * }
+     * ```
+     *
+     * The budget bounds the worst case (~max_n cached stores); the
+     * running total feeds tx_descriptors_reclaimed() for drain/shutdown
+     * accounting.
+     *
+     * @return Number of descriptors retired this call
+     */
+    inline uint32_t reclaim_budgeted(uint32_t max_n = 32) {
+        const uint32_t hw_head = read_reg32(reg::TX_HEAD);  // ONE MMIO per batch
+        uint32_t reclaimed = 0;
+        while (tx_reclaim_head_ != hw_head && reclaimed < max_n) {
+            // Scrub the retired descriptor — a stale cmd_type_len must
+            // never be re-submitted by accident
+            tx_ring_[tx_reclaim_head_].cmd_type_len = 0;
+            tx_reclaim_head_ = (tx_reclaim_head_ + 1) & (TX_RING_SIZE - 1);
+            reclaimed++;
+        }
+        tx_reclaimed_total_ += reclaimed;
+        return reclaimed;
+    }
+
+    /// Running count of descriptors retired via reclaim_budgeted()
+    inline uint64_t tx_descriptors_reclaimed() const {
+        return tx_reclaimed_total_;
+    }
+
 private:
+    /**
+     * Park the core until the next RX descriptor line is written or the
+     * deadline expires (the quiet-period half of the adaptive loop)
+     *
+     * UMONITOR arms the monitor on the descriptor the NIC will complete
+     * NEXT; the re-check between arming and UMWAIT closes the race where
+     * the DMA write lands in that window (the monitor would still be
+     * armed, but checking costs one cached load and saves a full wait).
+     */
+    inline void idle_wait_on_rx(uint64_t max_wait_ns) {
+        volatile RXDescriptor* desc = &rx_ring_[rx_head_];
+
+        #if defined(__WAITPKG__)
+        // Ice Lake+: monitor the descriptor cache line, sleep in C0.2
+        // (state 0). Wake sources: a write to the line, the TSC
+        // deadline, or any interrupt — all ~100 ns resume.
+        __builtin_ia32_umonitor(const_cast<RXDescriptor*>(desc));
+        if (!(desc->status_flags & RX_DD_BIT)) {
+            const uint64_t deadline = ull_nic::get_timestamp() +
+                ull_nic::tsc_calibration().to_ticks(max_wait_ns);
+            __builtin_ia32_umwait(0, deadline);
+        }
+        #elif defined(__x86_64__) || defined(__i386__)
+        // Pre-WAITPKG parts: PAUSE loop against the same deadline. No
+        // C-state, but PAUSE frees pipeline slots for the SMT sibling
+        // and drops power a few watts per core.
+        const uint64_t deadline = ull_nic::get_timestamp() +
+            ull_nic::tsc_calibration().to_ticks(max_wait_ns);
+        while (!(desc->status_flags & RX_DD_BIT) &&
+               ull_nic::get_timestamp() < deadline) {
+            __builtin_ia32_pause();
+        }
+        #else
+        (void)desc;
+        (void)max_wait_ns;
+        #endif
+    }
+
+    // Wire-to-poll latency (poll_rx_ts records; one histogram per
+    // driver instance = per RX queue owner, merge across instances on read)
+    ull_nic::LatencyHistogram wire_to_poll_hist_;
+
     // Memory-mapped hardware registers (BAR0)
     volatile uint8_t* bar0_base_;
-    
+
+    // NUMA node the NIC's PCIe root complex hangs off (sysfs)
+    int nic_numa_node_ = ull_nic::NumaPlacement::NODE_UNKNOWN;
+
+    // Hugepage arena backing ALL rings and packet buffers (one mmap total)
+    ull_nic::DMAArena dma_arena_;
+
     // Descriptor rings (shared with hardware via DMA)
     RXDescriptor* rx_ring_;
     TXDescriptor* tx_ring_;
@@ -555,9 +1675,61 @@ private:
     // Software head/tail pointers
     uint32_t rx_head_;
     uint32_t tx_tail_;
-    
+
     bool initialized_;
-    
+
+    // Multi-queue RX state (queue 0 aliases the single-queue ring above)
+    RxQueueHandle rx_queues_[MAX_RX_QUEUES];
+    size_t num_rx_queues_ = 0;
+
+    // Burst TX state: descriptors staged since the last doorbell
+    size_t tx_pending_ = 0;
+    size_t tx_autoflush_threshold_ = 0;  // 0 = flush manually
+
+    // Zero-copy TX: registered user regions (pages resolved in phys_table_)
+    struct TxRegion {
+        uint8_t* base = nullptr;
+        size_t len = 0;
+        int table_id = -1;  // Region id in phys_table_
+    };
+    TxRegion tx_regions_[MAX_TX_REGIONS];
+    size_t num_tx_regions_ = 0;
+
+    // Cached virt→phys translations for the arena and all TX regions
+    ull_nic::PhysTranslationTable phys_table_;
+
+    // Monotonic TX submission counter (buffer-reuse epochs)
+    uint64_t tx_submit_seq_ = 0;
+
+    // Lazy reclamation state: software retire cursor (trails the
+    // hardware TX head) and running retired-descriptor count
+    uint32_t tx_reclaim_head_ = 0;
+    uint64_t tx_reclaimed_total_ = 0;
+
+    // Last PHC↔TSC sync point (see sync_phc_tsc)
+    PhcTscCorrelation phc_correlation_;
+
+    /**
+     * Program RSS hash key and redirection table (round-robin over queues)
+     *
+     * The NIC hashes each flow's 5-tuple with the key, then indexes the
+     * 128-entry table with the hash to pick a destination queue. Same flow
+     * always lands on the same queue → no cross-core reordering.
+     */
+    void configure_rss(size_t num_queues) {
+        // Write RSS hash key (fixed pseudo-random pattern is fine — we only
+        // need even flow distribution, not cryptographic strength)
+        for (int i = 0; i < 10; i++) {
+            write_reg32(reg::RSS_KEY_BASE + (i * 4), 0x6b + (i * 0x1f3d));
+        }
+
+        // Fill redirection table round-robin
+        for (int i = 0; i < 128; i++) {
+            write_reg32(reg::RSS_TABLE_BASE + (i * 4),
+                        static_cast<uint32_t>(i % num_queues));
+        }
+    }
+
     /**
      * Read 32-bit hardware register
      * 
@@ -631,13 +1803,23 @@ private:
     
     /**
      * Convert virtual address to physical address
-     * 
+     *
      * Required for DMA - hardware needs physical addresses!
-     * 
-     * Method: Read /proc/self/pagemap
+     *
+     * Fast path: the DMA arena and every registered TX region were bulk
+     * resolved into phys_table_ at init, so this is a branch-free array
+     * lookup (~2-4 ns). The per-call /proc/self/pagemap read (three
+     * syscalls, ~1-2 μs) survives only as a fallback for addresses
+     * outside any registered region.
      */
     uint64_t virt_to_phys(const void* virt_addr) const {
-        // Open pagemap file
+        // Fast path: cached translation table
+        const uint64_t cached = phys_table_.lookup(virt_addr);
+        if (cached != 0) [[likely]] {
+            return cached;
+        }
+
+        // Slow path: unregistered address — read the pagemap directly
         int fd = open("/proc/self/pagemap", O_RDONLY);
         if (fd < 0) [[unlikely]] {
             return 0;
@@ -743,23 +1925,24 @@ public:
      */
     inline bool parse_market_data(const uint8_t* packet, size_t len,
                                    double* price, uint32_t* quantity) {
-        // HOT PATH: We KNOW the format, so just read the fields!
-        
-        // Ethernet (14) + IP (20) + UDP (8) = 42 bytes header
-        // Our data starts at offset 42
-        constexpr size_t PRICE_OFFSET = 42;
-        constexpr size_t QTY_OFFSET = 50;
-        
-        // Read price (8 bytes, unaligned load)
-        *price = *reinterpret_cast<const double*>(packet + PRICE_OFFSET);
-        
-        // Read quantity (4 bytes, unaligned load)
-        *quantity = *reinterpret_cast<const uint32_t*>(packet + QTY_OFFSET);
-        
-        // That's it! No loops, no branches, no validation.
-        // Modern CPUs handle unaligned loads in ~5ns each.
-        
-        return true;
+        // HOT PATH: the layout comes from the CME_MDP3 descriptor type
+        // (protocol_descriptors.hpp) — same 2 loads the old hardcoded
+        // 42/50 constants compiled to, but the offsets are reviewable
+        // against the spec in one place.
+        return protocol::parse<protocol::CME_MDP3>(packet, len, price, quantity);
+    }
+
+    /**
+     * Parse against any protocol descriptor (MDP3 / ITCH / internal SBE)
+     *
+     * Zero runtime dispatch: each instantiation compiles to that feed's
+     * 2-3 loads. Adding a feed is a new descriptor type in
+     * protocol_descriptors.hpp, not a new hand-rolled parser here.
+     */
+    template<typename Protocol>
+    inline bool parse_market_data_as(const uint8_t* packet, size_t len,
+                                     double* price, uint32_t* quantity) {
+        return protocol::parse<Protocol>(packet, len, price, quantity);
     }
     
     /**
@@ -807,6 +1990,273 @@ public:
         // That's it! No serialization loops, no protocol logic.
         // Just 2 memory stores into a pre-built template.
     }
+
+    /**
+     * Parse a whole RX burst at once into SoA output arrays
+     *
+     * Pairs with poll_rx_burst(): once the poll loop drains 32+ packets
+     * per iteration, calling parse_market_data in a scalar loop wastes
+     * the superscalar width — each packet's two loads depend on a
+     * pointer chase the compiler can't vectorize across iterations.
+     *
+     * This version extracts the offset-42 price and offset-50 quantity
+     * from FOUR packets per step:
+     *
+     * - AVX2: one VGATHERQPD for 4 prices + one VPGATHERQD for 4
+     *   quantities per group — the gathers for consecutive groups
+     *   overlap in the load pipes, hiding most of the latency
+     * - NEON (Graviton/ARM64NICDriver hosts): no gather instruction, so
+     *   4 packets' fields are loaded into lanes and stored as one
+     *   vector per output array — same unrolled shape, same SoA result
+     *
+     * Outputs are structure-of-arrays on purpose: the feature pipeline
+     * consumes prices[] with vector loads directly, no AoS→SoA shuffle.
+     *
+     * Performance: ~2-4 ns/packet (vs ~10 ns/packet scalar)
+     *
+     * @param pkts Array of packet pointers (e.g. from RxBurstEntry.data)
+     * @param n Number of packets
+     * @param prices Output: n prices (SoA)
+     * @param qtys Output: n quantities (SoA)
+     */
+    inline void parse_market_data_batch(const uint8_t* const* pkts, size_t n,
+                                        double* prices, uint32_t* qtys) {
+        // Offsets come from the same descriptor the scalar parser uses
+        constexpr size_t PRICE_OFFSET = protocol::CME_MDP3::PriceField::OFFSET;
+        constexpr size_t QTY_OFFSET = protocol::CME_MDP3::QtyField::OFFSET;
+
+        size_t i = 0;
+
+        #if defined(__AVX2__)
+        for (; i + 4 <= n; i += 4) {
+            // Packet addresses as 64-bit gather indices (scale 1, base 0)
+            const __m256i ptrs = _mm256_loadu_si256(
+                reinterpret_cast<const __m256i*>(pkts + i));
+
+            const __m256i price_addrs =
+                _mm256_add_epi64(ptrs, _mm256_set1_epi64x(PRICE_OFFSET));
+            const __m256i qty_addrs =
+                _mm256_add_epi64(ptrs, _mm256_set1_epi64x(QTY_OFFSET));
+
+            // 4 prices and 4 quantities in two gathers
+            const __m256d price_vec = _mm256_i64gather_pd(
+                reinterpret_cast<const double*>(0), price_addrs, 1);
+            const __m128i qty_vec = _mm256_i64gather_epi32(
+                reinterpret_cast<const int*>(0), qty_addrs, 1);
+
+            _mm256_storeu_pd(prices + i, price_vec);
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(qtys + i), qty_vec);
+        }
+        #elif defined(__ARM_NEON)
+        for (; i + 4 <= n; i += 4) {
+            // No gather on NEON — load each field into a lane, store the
+            // group as one vector per output array
+            float64x2_t p01 = vld1q_dup_f64(
+                reinterpret_cast<const double*>(pkts[i] + PRICE_OFFSET));
+            p01 = vld1q_lane_f64(
+                reinterpret_cast<const double*>(pkts[i + 1] + PRICE_OFFSET),
+                p01, 1);
+            float64x2_t p23 = vld1q_dup_f64(
+                reinterpret_cast<const double*>(pkts[i + 2] + PRICE_OFFSET));
+            p23 = vld1q_lane_f64(
+                reinterpret_cast<const double*>(pkts[i + 3] + PRICE_OFFSET),
+                p23, 1);
+
+            uint32x4_t q = vdupq_n_u32(0);
+            q = vld1q_lane_u32(
+                reinterpret_cast<const uint32_t*>(pkts[i] + QTY_OFFSET), q, 0);
+            q = vld1q_lane_u32(
+                reinterpret_cast<const uint32_t*>(pkts[i + 1] + QTY_OFFSET), q, 1);
+            q = vld1q_lane_u32(
+                reinterpret_cast<const uint32_t*>(pkts[i + 2] + QTY_OFFSET), q, 2);
+            q = vld1q_lane_u32(
+                reinterpret_cast<const uint32_t*>(pkts[i + 3] + QTY_OFFSET), q, 3);
+
+            vst1q_f64(prices + i, p01);
+            vst1q_f64(prices + i + 2, p23);
+            vst1q_u32(qtys + i, q);
+        }
+        #endif
+
+        // Scalar tail (and the whole burst on plain builds)
+        for (; i < n; i++) {
+            prices[i] = *reinterpret_cast<const double*>(pkts[i] + PRICE_OFFSET);
+            qtys[i] = *reinterpret_cast<const uint32_t*>(pkts[i] + QTY_OFFSET);
+        }
+    }
+};
+
+// ============================================================================
+// Warm-Start: go-live latency == steady-state latency
+// ============================================================================
+
+/**
+ * What WarmStart::run() reports back
+ */
+struct WarmupReport {
+    size_t pages_touched;           // DMA arena pages pre-faulted
+    size_t packets_run;             // Synthetic packets pushed through
+    uint64_t first_packet_ns;       // Cold-path latency (the problem)
+    uint64_t steady_state_p50_ns;   // Warm-path latency (the goal)
+    size_t packets_to_steady_state; // How many packets warming took
+    bool reached_steady_state;      // False: n_packets was too small
+};
+
+/**
+ * WarmStart: pre-fault memory and train predictors before go-live
+ *
+ * First-packet latency after process start is 10-100x steady state:
+ *
+ * 1. DMA pages are unmapped-until-touch — the first packet landing in
+ *    a cold RX buffer eats a minor fault (handled by
+ *    pretouch_dma_pages(), called from initialize())
+ * 2. The branch predictors in the poll loop and
+ *    CustomPacketFilter::parse_market_data are untrained, and the
+ *    I-cache doesn't hold the hot path yet — a few hundred ns of
+ *    mispredicts and instruction fetches on the first iterations
+ *
+ * We restart ahead of each session, and the FIRST real tick is the one
+ * that matters. run() closes the gap by pushing N synthetic packets
+ * through the full poll→parse→callback path — injected via
+ * loopback_rx_inject() so they traverse the REAL descriptors, buffers
+ * and branches — before any exchange byte arrives.
+ *
+ * Synthetic packets are FLAGGED (high bit of the quantity field, which
+ * no real feed uses) so the strategy callback can discard them:
+ *
+ * ```cpp
+ * auto report = WarmStart::run(nic, [&](const uint8_t* pkt, size_t len) {
+ *     strategy.on_packet(pkt, len);  // Internally: if (WarmStart::is_warmup_packet(pkt, len)) return;
+ * });
+ * WarmStart::print_report(report);   // Verify before enabling order flow
+ * ```
+ */
+class WarmStart {
+public:
+    /// Set on the quantity field of synthetic packets — real feeds never
+    /// carry quantities with the high bit set
+    static constexpr uint32_t WARMUP_QTY_FLAG = 0x80000000u;
+
+    static constexpr size_t MAX_WARMUP_PACKETS = 8192;
+    static constexpr size_t CHUNK = 64;  // Steady-state detection granularity
+
+    /// True when a packet is warm-up traffic the strategy must discard
+    static inline bool is_warmup_packet(const uint8_t* packet, size_t len) {
+        if (len < 54) [[unlikely]] {
+            return false;
+        }
+        const uint32_t qty = *reinterpret_cast<const uint32_t*>(packet + 50);
+        return (qty & WARMUP_QTY_FLAG) != 0;
+    }
+
+    /**
+     * Run the warm-up: n_packets synthetic ticks through the hot path
+     *
+     * Each iteration is the real go-live sequence — inject (what the
+     * NIC does on receive), poll_rx, parse, callback — timed end to
+     * end. Steady state is declared when a 64-packet chunk's mean
+     * latency falls within 1.5x of the final-quarter mean.
+     *
+     * @param callback Same shape as busy_wait_loop's: (packet, len).
+     *        Pass the REAL strategy entry point — warming a stand-in
+     *        trains the wrong branches.
+     */
+    template<typename Callback>
+    static WarmupReport run(CustomNICDriver& nic, Callback&& callback,
+                            size_t n_packets = 2048) {
+        WarmupReport report = {};
+        if (n_packets > MAX_WARMUP_PACKETS) {
+            n_packets = MAX_WARMUP_PACKETS;
+        }
+
+        // Calibrate the TSC clock NOW — lazily, it would happen inside
+        // the first timed iteration and masquerade as packet latency
+        (void)ull_nic::tsc_calibration().frequency_hz();
+
+        // Re-touch is idempotent; counts pages for the report
+        report.pages_touched = nic.pretouch_dma_pages();
+
+        // One flagged synthetic tick, realistic layout (the parser reads
+        // offsets 42/50 — those must hold plausible values)
+        CustomPacketFilter filter;
+        uint8_t synthetic[64];
+        size_t synthetic_len;
+        filter.build_order_packet(synthetic, &synthetic_len,
+                                  4500.25, 100 | WARMUP_QTY_FLAG);
+
+        static uint64_t latencies[MAX_WARMUP_PACKETS];  // Init-time only
+
+        uint8_t* packet_data;
+        size_t packet_len;
+        double price;
+        uint32_t quantity;
+
+        for (size_t i = 0; i < n_packets; i++) {
+            const uint64_t t0 = ull_nic::get_timestamp();
+
+            if (!nic.loopback_rx_inject(synthetic, synthetic_len)) [[unlikely]] {
+                break;  // Ring full — shouldn't happen with 1-in-1-out
+            }
+            if (!nic.poll_rx(&packet_data, &packet_len)) [[unlikely]] {
+                break;
+            }
+            filter.parse_market_data(packet_data, packet_len, &price, &quantity);
+            callback(packet_data, packet_len);
+
+            latencies[i] = ull_nic::tsc_calibration().to_ns(
+                ull_nic::get_timestamp() - t0);
+            report.packets_run++;
+        }
+
+        if (report.packets_run == 0) [[unlikely]] {
+            return report;
+        }
+        report.first_packet_ns = latencies[0];
+
+        // Steady-state baseline: mean of the final quarter
+        const size_t n = report.packets_run;
+        const size_t tail_start = n - n / 4;
+        uint64_t tail_sum = 0;
+        ull_nic::LatencyHistogram tail_hist;
+        for (size_t i = tail_start; i < n; i++) {
+            tail_sum += latencies[i];
+            tail_hist.record(latencies[i]);
+        }
+        const uint64_t baseline =
+            (n > tail_start) ? tail_sum / (n - tail_start) : 0;
+        report.steady_state_p50_ns = tail_hist.value_at_percentile(50.0);
+
+        // First 64-packet chunk whose mean is within 1.5x of baseline
+        for (size_t c = 0; c + CHUNK <= n; c += CHUNK) {
+            uint64_t sum = 0;
+            for (size_t i = c; i < c + CHUNK; i++) {
+                sum += latencies[i];
+            }
+            if (sum / CHUNK <= baseline + baseline / 2) {
+                report.packets_to_steady_state = c + CHUNK;
+                report.reached_steady_state = true;
+                break;
+            }
+        }
+
+        return report;
+    }
+
+    static void print_report(const WarmupReport& report) {
+        printf("=== Warm-Start Report ===\n");
+        printf("DMA pages pre-faulted:  %zu\n", report.pages_touched);
+        printf("Synthetic packets run:  %zu\n", report.packets_run);
+        printf("First packet (cold):    %lu ns\n",
+               static_cast<unsigned long>(report.first_packet_ns));
+        printf("Steady state (p50):     %lu ns\n",
+               static_cast<unsigned long>(report.steady_state_p50_ns));
+        if (report.reached_steady_state) {
+            printf("Steady after:           %zu packets\n",
+                   report.packets_to_steady_state);
+        } else {
+            printf("Steady state NOT reached — increase n_packets\n");
+        }
+    }
 };
 
 // ============================================================================
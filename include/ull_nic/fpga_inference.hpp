@@ -0,0 +1,101 @@
+// fpga_inference.hpp
+// Software stub of the FPGA DNN inference engine
+//
+// PURPOSE:
+// - Deterministic ~400ns software implementation of the accelerator's
+//   model, so strategy code and HardwareInTheLoopBridge run unmodified
+//   on hosts without the FPGA card
+// - Same feature layout the hardware DMA path uses (8 floats, in the
+//   order the bitstream's input stage expects)
+//
+// The weights here are placeholders — the production bitstream loads
+// the real model into BRAM at initialize time. What matters for the
+// bridge is the CONTRACT: predict(features) -> 4 outputs, output[0]
+// is the primary signal.
+
+#pragma once
+
+#include <array>
+#include <cmath>
+#include <cstddef>
+
+namespace hft {
+
+// Feature vector the accelerator consumes (one cache line of doubles).
+// Field order MUST match the FPGA input stage — the DMA path copies
+// these in declaration order.
+struct MicrostructureFeatures {
+    double ofi_level_1 = 0.0;      // Order-flow imbalance, top of book
+    double ofi_level_5 = 0.0;      // OFI aggregated over 5 levels
+    double ofi_level_10 = 0.0;     // OFI aggregated over 10 levels
+    double trade_imbalance = 0.0;  // Signed trade volume imbalance
+    double spread = 0.0;           // Ask - bid
+    double volatility = 0.0;       // Short-window realized vol
+    double microprice = 0.0;       // Size-weighted mid
+    double queue_imbalance = 0.0;  // Bid size / (bid size + ask size)
+};
+
+static constexpr size_t FPGA_NUM_FEATURES = 8;
+static constexpr size_t FPGA_NUM_OUTPUTS = 4;
+
+// Two-layer feed-forward stub: 8 -> 16 -> 4 with fixed weights.
+// Small enough to run in ~400ns deterministically; the FPGA runs the
+// same topology in ~40ns wall time plus PCIe transit.
+class FPGA_DNN_Inference {
+public:
+    static constexpr size_t HIDDEN = 16;
+
+    FPGA_DNN_Inference() {
+        // Deterministic placeholder weights (production: loaded from
+        // the model file that also programs the bitstream's BRAM)
+        for (size_t i = 0; i < HIDDEN; i++) {
+            for (size_t j = 0; j < FPGA_NUM_FEATURES; j++) {
+                w1_[i][j] = 0.05 * static_cast<double>((i + j) % 7 - 3);
+            }
+            b1_[i] = 0.01 * static_cast<double>(i % 5 - 2);
+        }
+        for (size_t o = 0; o < FPGA_NUM_OUTPUTS; o++) {
+            for (size_t i = 0; i < HIDDEN; i++) {
+                w2_[o][i] = 0.1 * static_cast<double>((o + i) % 5 - 2);
+            }
+            b2_[o] = 0.0;
+        }
+    }
+
+    std::array<double, FPGA_NUM_OUTPUTS> predict(
+            const MicrostructureFeatures& f) const {
+        const double in[FPGA_NUM_FEATURES] = {
+            f.ofi_level_1, f.ofi_level_5, f.ofi_level_10,
+            f.trade_imbalance, f.spread, f.volatility,
+            f.microprice, f.queue_imbalance,
+        };
+
+        double hidden[HIDDEN];
+        for (size_t i = 0; i < HIDDEN; i++) {
+            double acc = b1_[i];
+            for (size_t j = 0; j < FPGA_NUM_FEATURES; j++) {
+                acc += w1_[i][j] * in[j];
+            }
+            // ReLU — matches the hardware's piecewise activation
+            hidden[i] = (acc > 0.0) ? acc : 0.0;
+        }
+
+        std::array<double, FPGA_NUM_OUTPUTS> out;
+        for (size_t o = 0; o < FPGA_NUM_OUTPUTS; o++) {
+            double acc = b2_[o];
+            for (size_t i = 0; i < HIDDEN; i++) {
+                acc += w2_[o][i] * hidden[i];
+            }
+            out[o] = std::tanh(acc);  // Bounded signal in [-1, 1]
+        }
+        return out;
+    }
+
+private:
+    double w1_[HIDDEN][FPGA_NUM_FEATURES];
+    double b1_[HIDDEN];
+    double w2_[FPGA_NUM_OUTPUTS][HIDDEN];
+    double b2_[FPGA_NUM_OUTPUTS];
+};
+
+} // namespace hft
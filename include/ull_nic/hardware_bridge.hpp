@@ -22,6 +22,7 @@
 
 #include "common_types.hpp"
 #include "fpga_inference.hpp"
+#include "latency_histogram.hpp"
 #include <atomic>
 #include <memory>
 #include <optional>
@@ -35,7 +36,8 @@ using hft::FPGA_DNN_Inference;
 enum class AcceleratorMode {
     SOFTWARE_STUB,      // Use FPGAInference C++ implementation (development)
     HARDWARE_FPGA,      // Route to actual FPGA card (production)
-    HYBRID_FALLBACK     // FPGA with software fallback on timeout
+    HYBRID_FALLBACK,    // FPGA with software fallback on timeout
+    BATCHED_ASYNC       // Double-buffered batch pipeline (throughput mode)
 };
 
 // Hardware health status
@@ -52,6 +54,7 @@ struct HardwareLatencyStats {
     double p50_ns;
     double p95_ns;
     double p99_ns;
+    double p999_ns;
     double max_ns;
     uint64_t total_inferences;
     uint64_t hardware_failures;
@@ -108,7 +111,16 @@ public:
                 // Hardware failed, switch to software mode
                 mode_.store(AcceleratorMode::SOFTWARE_STUB, std::memory_order_release);
                 return initialize_software_stub();
-            
+
+            case AcceleratorMode::BATCHED_ASYNC:
+                // Batch pipeline runs over whichever engine is available;
+                // without the card it drives the software stub so the
+                // submit/poll contract can be exercised end to end.
+                // Production: also configures the batched DMA descriptor
+                // ring and doorbell (one kick per batch, not per item).
+                initialize_fpga_hardware();  // Best effort
+                return initialize_software_stub();
+
             default:
                 return false;
         }
@@ -150,6 +162,13 @@ public:
                     success = true;
                 }
                 break;
+
+            case AcceleratorMode::BATCHED_ASYNC:
+                // Single-item calls stay on the existing fast path —
+                // the batch pipeline is submit_async()/poll_completions()
+                prediction = predict_software(features);
+                success = true;
+                break;
         }
         
         // Track latency statistics
@@ -162,10 +181,90 @@ public:
         return prediction;
     }
 
+    // ========================================================================
+    // Batched Async Pipeline (BATCHED_ASYNC mode)
+    // ========================================================================
+    //
+    // The per-prediction round trip in predict_hardware is dominated by
+    // FIXED PCIe transaction cost: a posted write to the doorbell, the
+    // DMA setup, and the completion poll come to ~1-2 us whether the
+    // payload is one feature vector or sixty-four. Batching amortizes
+    // that fixed cost: submit features into a double-buffered staging
+    // area, kick the accelerator ONCE per batch, and poll completions
+    // without blocking.
+    //
+    // Double buffering is what makes it a pipeline: while batch A is in
+    // flight on the card, submissions fill batch B — the PCIe transfer
+    // overlaps feature staging instead of serializing with it.
+    //
+    // PRODUCTION MAPPING:
+    // - Staging buffers live in the huge-page DMA area (fpga_dma_buffer_)
+    // - kick = one doorbell write with the batch descriptor (base, count)
+    // - completion = FPGA writes a done-count the poll reads, no IRQ
+    //
+    // Single-item latency is untouched: predict() keeps its fast path.
+
+    static constexpr size_t BATCH_CAPACITY = 64;
+
+    // Queue one feature vector into the staging batch. Returns false on
+    // backpressure (both buffers occupied and completions not drained) —
+    // the caller decides whether to poll or fall back to predict().
+    bool submit_async(const MicrostructureFeatures& features) {
+        InferenceBatch& staging = batches_[staging_idx_];
+
+        if (staging.in_flight.load(std::memory_order_acquire)) {
+            // Both buffers busy: the drain side hasn't kept up
+            return false;
+        }
+
+        staging.features[staging.count++] = features;
+
+        if (staging.count == BATCH_CAPACITY) {
+            kick_batch();
+        }
+        return true;
+    }
+
+    // Kick a partial batch (end of a packet burst, before going idle).
+    // No-op when nothing is staged.
+    void flush_batch() {
+        if (batches_[staging_idx_].count > 0 &&
+            !batches_[staging_idx_].in_flight.load(std::memory_order_acquire)) {
+            kick_batch();
+        }
+    }
+
+    // Non-blocking completion poll: copies up to max finished predictions
+    // (in submission order) into out. Returns the number drained.
+    size_t poll_completions(double* out, size_t max) {
+        InferenceBatch& batch = batches_[drain_idx_];
+
+        if (!batch.done.load(std::memory_order_acquire)) {
+            return 0;  // Nothing finished — caller keeps doing real work
+        }
+
+        size_t drained = 0;
+        while (drained < max && drain_pos_ < batch.count) {
+            out[drained++] = batch.predictions[drain_pos_++];
+        }
+
+        if (drain_pos_ == batch.count) {
+            // Batch fully consumed — recycle the buffer for staging
+            batch.count = 0;
+            drain_pos_ = 0;
+            batch.done.store(false, std::memory_order_relaxed);
+            batch.in_flight.store(false, std::memory_order_release);
+            drain_idx_ ^= 1;
+        }
+
+        total_inferences_.fetch_add(drained, std::memory_order_relaxed);
+        return drained;
+    }
+
     // ========================================================================
     // Hardware Management
     // ========================================================================
-    
+
     // Switch accelerator mode at runtime (hot-swap)
     bool set_mode(AcceleratorMode new_mode) {
         if (new_mode == mode_.load(std::memory_order_acquire)) {
@@ -181,29 +280,42 @@ public:
         return status_.load(std::memory_order_acquire);
     }
     
-    // Get latency statistics for monitoring
+    // Get latency statistics for monitoring.
+    // Percentiles come from the per-core histograms merged at read time —
+    // the merge walks 16 KB per recording core, so call this from the
+    // monitoring thread, not the trading loop.
     HardwareLatencyStats get_latency_stats() const {
         const uint64_t count = total_inferences_.load(std::memory_order_acquire);
         if (count == 0) {
-            return {0.0, 0.0, 0.0, 0.0, 0.0, 0, 0, 0};
+            return {0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0, 0, 0};
         }
-        
+
+        const ull_nic::LatencyHistogram merged = latency_hist_.merged();
+
         return {
             latency_sum_ns_.load(std::memory_order_acquire) / count,  // Mean
-            0.0,  // P50 (requires histogram, omitted for simplicity)
-            0.0,  // P95
-            0.0,  // P99
-            max_latency_ns_.load(std::memory_order_acquire),
+            static_cast<double>(merged.value_at_percentile(50.0)),
+            static_cast<double>(merged.value_at_percentile(95.0)),
+            static_cast<double>(merged.value_at_percentile(99.0)),
+            static_cast<double>(merged.value_at_percentile(99.9)),
+            static_cast<double>(merged.max()),
             count,
             hardware_failures_.load(std::memory_order_acquire),
             software_fallbacks_.load(std::memory_order_acquire)
         };
     }
-    
-    // Check if inference latency meets SLA (400ns for software, configurable for hardware)
-    bool meets_latency_sla(double sla_ns = 400.0) const {
-        const auto stats = get_latency_stats();
-        return stats.mean_ns <= sla_ns;
+
+    // Check if inference latency meets SLA — judged at a PERCENTILE, not
+    // the mean. A 400ns mean with a 8us p99.9 passes the old check and
+    // fails in production; this one catches it.
+    bool meets_latency_sla(double sla_ns = 400.0, double percentile = 99.0) const {
+        return latency_hist_.meets_latency_sla(
+            static_cast<uint64_t>(sla_ns), percentile);
+    }
+
+    // Direct access for the monitoring thread (print_report etc.)
+    const ull_nic::PerCoreLatencyHistogram<16>& latency_histogram() const {
+        return latency_hist_;
     }
 
 private:
@@ -386,11 +498,50 @@ private:
         return false;
     }
     
+    // ========================================================================
+    // Batched Pipeline Internals
+    // ========================================================================
+
+    struct InferenceBatch {
+        MicrostructureFeatures features[BATCH_CAPACITY];
+        double predictions[BATCH_CAPACITY];
+        size_t count = 0;
+        std::atomic<bool> in_flight{false};
+        std::atomic<bool> done{false};
+    };
+
+    // Seal the staging batch, kick the accelerator once, swap buffers.
+    //
+    // PRODUCTION: this is ONE doorbell write (batch base + count) after
+    // which the card DMAs the whole staging area and writes predictions
+    // + a done flag back — the code below is the software-stub stand-in
+    // that executes the same contract inline, so the pipeline can be
+    // driven end to end without the card.
+    void kick_batch() {
+        InferenceBatch& batch = batches_[staging_idx_];
+        batch.in_flight.store(true, std::memory_order_release);
+
+        for (size_t i = 0; i < batch.count; i++) {
+            auto outputs = software_inference_->predict(batch.features[i]);
+            batch.predictions[i] = outputs[0];
+        }
+
+        batch.done.store(true, std::memory_order_release);
+
+        // Swap: new submissions fill the other buffer while this one
+        // drains through poll_completions
+        staging_idx_ ^= 1;
+    }
+
     // ========================================================================
     // Latency Statistics
     // ========================================================================
     
     void update_latency_stats(double latency_ns) {
+        // Histogram record: integer-only, per-core shard, ~3-5 ns — this
+        // is where the percentiles come from
+        latency_hist_.record(static_cast<uint64_t>(latency_ns));
+
         // Atomic double addition using CAS loop
         double old_val = latency_sum_ns_.load(std::memory_order_relaxed);
         while (!latency_sum_ns_.compare_exchange_weak(old_val, old_val + latency_ns,
@@ -424,7 +575,15 @@ private:
     // volatile uint32_t* fpga_control_regs_; // Memory-mapped control registers
     // float* fpga_dma_buffer_;               // DMA buffer for features/predictions
     
+    // Batched async pipeline state (submit and poll from one thread;
+    // the atomics order the handoff against the — future — DMA engine)
+    InferenceBatch batches_[2];
+    size_t staging_idx_ = 0;
+    size_t drain_idx_ = 0;
+    size_t drain_pos_ = 0;
+
     // Statistics
+    mutable ull_nic::PerCoreLatencyHistogram<16> latency_hist_;
     std::atomic<uint64_t> total_inferences_;
     std::atomic<uint64_t> hardware_failures_;
     std::atomic<uint64_t> software_fallbacks_;
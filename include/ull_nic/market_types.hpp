@@ -0,0 +1,101 @@
+#pragma once
+
+#include <cstdint>
+#include <chrono>
+
+/**
+ * Market Data Types for the Kernel-Bypass Layer
+ *
+ * These are the wire-adjacent structures KernelBypassNIC moves through its
+ * lock-free queue. Kept deliberately flat (no pointers, trivially copyable)
+ * so a tick can be memcpy'd straight out of a DMA buffer and pushed through
+ * the ring with no serialization step.
+ */
+
+namespace hft {
+
+// ============================================================================
+// Trade Side
+// ============================================================================
+
+enum class Side : uint8_t {
+    BUY  = 0,
+    SELL = 1
+};
+
+// ============================================================================
+// Timestamps
+// ============================================================================
+
+/**
+ * Nanosecond timestamp for market data stamping
+ *
+ * Uses steady_clock (monotonic) — market data sequencing must never go
+ * backwards on NTP adjustments.
+ */
+inline uint64_t now() {
+    return static_cast<uint64_t>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()
+        ).count()
+    );
+}
+
+// ============================================================================
+// Market Tick (full snapshot, 10-level book)
+// ============================================================================
+
+/// Number of LOB levels carried per tick
+constexpr size_t MARKET_DEPTH_LEVELS = 10;
+
+/**
+ * MarketTick: one full market data update with 10-level depth
+ *
+ * Layout notes:
+ * - Trivially copyable: safe to memcpy from DMA buffers and through rings
+ * - Cache-line aligned so queue slots never straddle a line boundary
+ * - Full snapshot format (~400 bytes) — every field, every level
+ */
+struct alignas(64) MarketTick {
+    uint64_t timestamp;       ///< Receive timestamp (nanoseconds)
+    uint32_t asset_id;        ///< Instrument identifier
+    uint32_t depth_levels;    ///< Number of valid LOB levels (<= 10)
+
+    // Top of book
+    double   mid_price;
+    double   bid_price;
+    double   ask_price;
+    uint32_t bid_size;
+    uint32_t ask_size;
+
+    // Last trade
+    uint32_t trade_volume;
+    Side     trade_side;
+    uint8_t  _pad[3];         ///< Explicit padding (keeps layout stable)
+
+    // Full depth (level 0 = best)
+    double   bid_prices[MARKET_DEPTH_LEVELS];
+    double   ask_prices[MARKET_DEPTH_LEVELS];
+    uint32_t bid_sizes[MARKET_DEPTH_LEVELS];
+    uint32_t ask_sizes[MARKET_DEPTH_LEVELS];
+
+    MarketTick()
+        : timestamp(0)
+        , asset_id(0)
+        , depth_levels(0)
+        , mid_price(0.0)
+        , bid_price(0.0)
+        , ask_price(0.0)
+        , bid_size(0)
+        , ask_size(0)
+        , trade_volume(0)
+        , trade_side(Side::BUY)
+        , _pad{0, 0, 0}
+        , bid_prices{}
+        , ask_prices{}
+        , bid_sizes{}
+        , ask_sizes{}
+    {}
+};
+
+} // namespace hft
@@ -0,0 +1,146 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+#include <fcntl.h>
+#include <unistd.h>
+
+/**
+ * @file phys_translation.hpp
+ * @brief Cached virtual→physical address translation for DMA regions
+ *
+ * The problem with per-call pagemap translation:
+ * ──────────────────────────────────────────────
+ *
+ * Reading /proc/self/pagemap costs THREE syscalls per translation
+ * (open + lseek/read + close, ~1-2 μs). Tolerable during one-time ring
+ * setup; fatal anywhere near the TX hot path. Fast zero-copy TX needs
+ * translation to cost a handful of nanoseconds.
+ *
+ * The fix: resolve every page of every registered DMA region ONCE, at
+ * registration time, with a single bulk pagemap read per region. The hot
+ * path then does a branch-free array lookup:
+ *
+ *     phys = page_table[offset >> 12] + (offset & 0xFFF)
+ *
+ * Cost: ~2-4 ns (one L1/L2 load) vs ~1-2 μs for the syscall path.
+ *
+ * Note on IOMMU setups: under VFIO type-1 the IOVA is whatever you map it
+ * to be — register the region and store your chosen IOVAs in the same
+ * table shape; the lookup path is identical.
+ */
+
+namespace ull_nic {
+
+class PhysTranslationTable {
+public:
+    /// Maximum number of registered DMA regions
+    static constexpr size_t MAX_REGIONS = 8;
+
+    static constexpr uint64_t PAGE_SIZE = 4096;
+
+    /**
+     * @brief Register a DMA region and resolve ALL its pages up front
+     *
+     * One open + one bulk read of /proc/self/pagemap covers the whole
+     * region. Pages must be resident (mlock first!) or the pagemap entry
+     * has no PFN and registration fails.
+     *
+     * @param base Region base (any alignment; translation is per-page)
+     * @param len Region length in bytes
+     * @return Region id for lookup_fast(), or -1 on failure
+     */
+    int register_region(const void* base, size_t len) {
+        if (num_regions_ >= MAX_REGIONS || !base || len == 0) {
+            return -1;
+        }
+
+        Region& region = regions_[num_regions_];
+        region.base = reinterpret_cast<uintptr_t>(base);
+        region.len = len;
+
+        const uintptr_t first_page = region.base / PAGE_SIZE;
+        const uintptr_t last_page = (region.base + len - 1) / PAGE_SIZE;
+        const size_t num_pages = last_page - first_page + 1;
+
+        // ONE bulk read of the pagemap entries for the whole region
+        std::vector<uint64_t> entries(num_pages);
+
+        int fd = open("/proc/self/pagemap", O_RDONLY);
+        if (fd < 0) {
+            return -1;
+        }
+
+        const ssize_t want = static_cast<ssize_t>(num_pages * 8);
+        const ssize_t got = pread(fd, entries.data(), want,
+                                  static_cast<off_t>(first_page * 8));
+        close(fd);
+
+        if (got != want) {
+            return -1;
+        }
+
+        // Extract physical frame addresses (bit 63 = page present)
+        region.page_phys.resize(num_pages);
+        for (size_t p = 0; p < num_pages; p++) {
+            if (!(entries[p] & (1ULL << 63))) {
+                return -1;  // Page not resident — mlock the region first
+            }
+            const uint64_t pfn = entries[p] & ((1ULL << 55) - 1);
+            region.page_phys[p] = pfn * PAGE_SIZE;
+        }
+
+        return static_cast<int>(num_regions_++);
+    }
+
+    /**
+     * @brief Branch-free hot-path lookup by region id + byte offset
+     *
+     * Performance: ~2-4 ns (one array load + add)
+     *
+     * @note No bounds checking — the offset must lie inside the region
+     *       that was registered (hot-path contract).
+     */
+    inline uint64_t lookup_fast(int region_id, uint64_t offset) const {
+        const Region& region = regions_[region_id];
+        const uint64_t page_off = (region.base & (PAGE_SIZE - 1)) + offset;
+        return region.page_phys[page_off >> 12] + (page_off & 0xFFF);
+    }
+
+    /**
+     * @brief Lookup by virtual address across all registered regions
+     *
+     * Small linear scan over at most MAX_REGIONS entries — still tens of
+     * times cheaper than one pagemap syscall. Use lookup_fast() when the
+     * region id is known.
+     *
+     * @return Physical address, or 0 if the address is in no registered region
+     */
+    inline uint64_t lookup(const void* virt_addr) const {
+        const uintptr_t virt = reinterpret_cast<uintptr_t>(virt_addr);
+
+        for (size_t r = 0; r < num_regions_; r++) {
+            const Region& region = regions_[r];
+            if (virt >= region.base && virt < region.base + region.len) {
+                return lookup_fast(static_cast<int>(r), virt - region.base);
+            }
+        }
+
+        return 0;  // Not registered
+    }
+
+    size_t num_regions() const { return num_regions_; }
+
+private:
+    struct Region {
+        uintptr_t base = 0;
+        size_t len = 0;
+        std::vector<uint64_t> page_phys;  // One physical address per page
+    };
+
+    Region regions_[MAX_REGIONS];
+    size_t num_regions_ = 0;
+};
+
+} // namespace ull_nic
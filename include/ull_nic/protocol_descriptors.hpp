@@ -0,0 +1,178 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <cstring>
+#include <type_traits>
+
+/**
+ * @file protocol_descriptors.hpp
+ * @brief Compile-time exchange protocol descriptors (zero runtime dispatch)
+ *
+ * The problem with the usual two options:
+ * ───────────────────────────────────────
+ *
+ * 1. Hand-rolled parsers (CustomPacketFilter's original 42/50 magic
+ *    constants): fastest possible, but every new feed is a new pile of
+ *    copy-pasted offsets nobody can review against the spec
+ * 2. Runtime protocol dispatch (a parser vtable or a switch on feed id):
+ *    reviewable, but puts an indirect branch on EVERY packet — 5-15 ns
+ *    and a BTB entry we need for the strategy code
+ *
+ * Descriptors give us both: a protocol's wire layout — field offsets,
+ * widths, endianness, fixed-point scale — is declared as a TYPE, and
+ * parse<Protocol>() instantiates into exactly the 2-3 loads the
+ * hand-rolled version had. Adding a feed is a new descriptor struct, not
+ * a new parser; getting an offset wrong is a one-line diff against the
+ * exchange spec, not an archaeology project.
+ *
+ * Usage:
+ * ```cpp
+ * double price; uint32_t qty;
+ * hft::protocol::parse<hft::protocol::CME_MDP3>(pkt, len, &price, &qty);
+ * ```
+ */
+
+namespace hft {
+namespace protocol {
+
+enum class Endian : uint8_t {
+    LITTLE,
+    BIG,
+};
+
+/**
+ * One wire field: type, byte offset, endianness — all compile-time.
+ *
+ * read() compiles to a single (unaligned) load, plus a byte swap only
+ * when the wire order differs from the host. The memcpy is the
+ * strict-aliasing-clean spelling; every compiler folds it to one mov.
+ */
+template<typename T, size_t ByteOffset, Endian E = Endian::LITTLE>
+struct Field {
+    using value_type = T;
+    static constexpr size_t OFFSET = ByteOffset;
+    static constexpr size_t WIDTH = sizeof(T);
+    static constexpr Endian ENDIAN = E;
+
+    static inline T read(const uint8_t* packet) {
+        T value;
+        std::memcpy(&value, packet + OFFSET, sizeof(T));
+
+        if constexpr (E == Endian::BIG) {
+            static_assert(std::is_integral_v<T>,
+                          "Big-endian fields must be integral "
+                          "(floating point is little-endian on every feed we run)");
+            if constexpr (sizeof(T) == 2) {
+                value = static_cast<T>(__builtin_bswap16(static_cast<uint16_t>(value)));
+            } else if constexpr (sizeof(T) == 4) {
+                value = static_cast<T>(__builtin_bswap32(static_cast<uint32_t>(value)));
+            } else if constexpr (sizeof(T) == 8) {
+                value = static_cast<T>(__builtin_bswap64(static_cast<uint64_t>(value)));
+            }
+        }
+
+        return value;
+    }
+};
+
+// ============================================================================
+// Feed Descriptors
+// ============================================================================
+
+/**
+ * CME MDP3-style feed (the layout CustomPacketFilter hardcoded):
+ * Ethernet(14) + IP(20) + UDP(8) = 42-byte header, then a little-endian
+ * IEEE double price and uint32 quantity.
+ */
+struct CME_MDP3 {
+    static constexpr size_t MIN_PACKET_LEN = 64;
+
+    using PriceField = Field<double, 42, Endian::LITTLE>;
+    using QtyField = Field<uint32_t, 50, Endian::LITTLE>;
+
+    /// Price arrives as a ready double — no fixed-point conversion
+    static constexpr double PRICE_SCALE = 1.0;
+};
+
+/**
+ * NASDAQ ITCH-style feed: big-endian throughout (classic network order),
+ * price as a uint32 fixed-point with 4 implied decimals.
+ */
+struct NASDAQ_ITCH {
+    static constexpr size_t MIN_PACKET_LEN = 50;
+
+    using PriceField = Field<uint32_t, 42, Endian::BIG>;
+    using QtyField = Field<uint32_t, 46, Endian::BIG>;
+
+    /// ITCH prices: 1 tick = 0.0001
+    static constexpr double PRICE_SCALE = 1e-4;
+};
+
+/**
+ * Internal SBE feed: little-endian, int64 price with 9 implied decimals
+ * (our serializer's fixed-point convention), uint32 quantity.
+ */
+struct InternalSBE {
+    static constexpr size_t MIN_PACKET_LEN = 62;
+
+    using PriceField = Field<int64_t, 42, Endian::LITTLE>;
+    using QtyField = Field<uint32_t, 50, Endian::LITTLE>;
+
+    static constexpr double PRICE_SCALE = 1e-9;
+};
+
+// ============================================================================
+// Descriptor Detection + Generic Parse
+// ============================================================================
+
+/// true when T declares the descriptor surface (PriceField/QtyField)
+template<typename T, typename = void>
+struct is_protocol_descriptor : std::false_type {};
+
+template<typename T>
+struct is_protocol_descriptor<T, std::void_t<typename T::PriceField,
+                                             typename T::QtyField>>
+    : std::true_type {};
+
+template<typename T>
+inline constexpr bool is_protocol_descriptor_v = is_protocol_descriptor<T>::value;
+
+/**
+ * @brief Parse price + quantity per a protocol descriptor (HOT PATH)
+ *
+ * Compiles down to: one length compare, 2 loads, and (for fixed-point
+ * feeds) one int→double convert and multiply — identical codegen to the
+ * hand-written parser for each feed. Verify with -S if you touch this.
+ *
+ * @return false only when the packet is shorter than the descriptor's
+ *         minimum (truncated datagram)
+ */
+template<typename Protocol>
+inline bool parse(const uint8_t* packet, size_t len,
+                  double* price, uint32_t* quantity) {
+    static_assert(is_protocol_descriptor_v<Protocol>,
+                  "Protocol must declare PriceField, QtyField, "
+                  "MIN_PACKET_LEN and PRICE_SCALE");
+
+    if (len < Protocol::MIN_PACKET_LEN) [[unlikely]] {
+        return false;
+    }
+
+    const auto raw_price = Protocol::PriceField::read(packet);
+
+    if constexpr (std::is_floating_point_v<
+                      typename Protocol::PriceField::value_type>) {
+        *price = static_cast<double>(raw_price);
+    } else {
+        // Fixed-point feed: scale is a compile-time constant, so this is
+        // one cvtsi2sd + one mulsd
+        *price = static_cast<double>(raw_price) * Protocol::PRICE_SCALE;
+    }
+
+    *quantity = static_cast<uint32_t>(Protocol::QtyField::read(packet));
+    return true;
+}
+
+} // namespace protocol
+} // namespace hft
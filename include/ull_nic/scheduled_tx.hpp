@@ -0,0 +1,270 @@
+#pragma once
+
+#include "common_types.hpp"
+
+#include <cstdint>
+#include <cstddef>
+#include <cstring>
+#include <type_traits>
+
+/**
+ * @file scheduled_tx.hpp
+ * @brief TSC timing wheel + NIC launch-time for hardware-paced transmit
+ *
+ * Why not sleep-then-send:
+ * ────────────────────────
+ *
+ * Exchange throttle compliance means pacing order flow — and pacing
+ * with nanosleep adds 10-50 us of wakeup jitter to EVERY paced send,
+ * plus the serialize + DMA cost lands after the wakeup, not before.
+ *
+ * The scheduled-TX engine splits "when" from "what":
+ *
+ * - Packets are PRE-SERIALIZED at schedule time into a fixed pool —
+ *   the bytes are ready long before the trigger
+ * - A TSC-resolution timing wheel holds them; the EXISTING polling
+ *   core drains due slots from its busy-wait loop (one compare per
+ *   empty poll), so release jitter is the wheel's slot resolution
+ *   (default 1 us), not a scheduler wakeup
+ * - Where the driver supports descriptor launch-time (X710-class
+ *   hardware, detected at compile time via submit_tx_at), due-soon
+ *   packets are handed to the NIC EARLY with the launch time in the
+ *   descriptor — the NIC holds the trigger and releases the frame at
+ *   the exact nanosecond. "Pace, then serialize, then DMA" becomes
+ *   just the trigger.
+ *
+ * Capacity model: WheelSlots x slot_ns is the scheduling horizon
+ * (4096 x 1 us ≈ 4 ms by default — throttle windows are well inside
+ * that). Scheduling past the horizon or into a full pool is REJECTED,
+ * not queued: a paced path must fail loudly, never silently late.
+ */
+
+namespace ull_nic {
+
+namespace detail {
+
+/// Detected when the driver exposes descriptor-level launch time
+/// (submit_tx_at(data, len, launch_time_ns)) — X710-class hardware
+template<typename D, typename = void>
+struct has_submit_tx_at : std::false_type {};
+template<typename D>
+struct has_submit_tx_at<D, std::void_t<decltype(
+    std::declval<D&>().submit_tx_at(std::declval<const uint8_t*>(),
+                                    std::declval<size_t>(),
+                                    std::declval<uint64_t>()))>>
+    : std::true_type {};
+
+} // namespace detail
+
+template<typename Driver,
+         size_t WheelSlots = 4096,
+         size_t PoolSize = 8192,
+         size_t MaxPacket = 512>
+class ScheduledTx {
+    static_assert((WheelSlots & (WheelSlots - 1)) == 0,
+                  "WheelSlots must be a power of two");
+
+public:
+    /// With hardware launch-time, slots this close to due are handed to
+    /// the NIC early — the descriptor's launch field does the last leg
+    static constexpr size_t HW_HANDOFF_SLOTS = 4;
+
+    /**
+     * @param slot_ns Wheel resolution — the worst-case software release
+     *        jitter (hardware launch-time shrinks it to NIC precision)
+     */
+    explicit ScheduledTx(Driver& driver, uint64_t slot_ns = 1'000)
+        : driver_(driver) {
+        slot_ticks_ = tsc_calibration().to_ticks(slot_ns);
+        if (slot_ticks_ == 0) {
+            slot_ticks_ = 1;
+        }
+        cursor_ = get_timestamp() / slot_ticks_;
+
+        for (uint32_t i = 0; i < PoolSize; i++) {
+            pool_[i].next = i + 1;
+        }
+        pool_[PoolSize - 1].next = NIL;
+        free_head_ = 0;
+
+        for (size_t i = 0; i < WheelSlots; i++) {
+            wheel_[i] = NIL;
+        }
+    }
+
+    ScheduledTx(const ScheduledTx&) = delete;
+    ScheduledTx& operator=(const ScheduledTx&) = delete;
+
+    /**
+     * @brief Schedule a pre-serialized packet for a TSC launch time
+     *
+     * The packet bytes are copied into the pool NOW (one bounded
+     * memcpy) — at launch time only the trigger remains. A launch time
+     * already in the past sends immediately (counted in late()).
+     *
+     * @return false when past the wheel horizon, the pool is full, or
+     *         the packet exceeds MaxPacket — the caller must know a
+     *         paced send did NOT get queued
+     */
+    bool schedule_at(const uint8_t* data, size_t len, uint64_t launch_tsc) {
+        if (len > MaxPacket) [[unlikely]] {
+            return false;
+        }
+
+        const uint64_t now = get_timestamp();
+        if (launch_tsc <= now) [[unlikely]] {
+            // Already due — the only honest option is "now"
+            late_++;
+            return submit(data, len, launch_tsc);
+        }
+
+        const uint64_t slot_tick = launch_tsc / slot_ticks_;
+        if (slot_tick - cursor_ >= WheelSlots) [[unlikely]] {
+            rejected_++;  // Beyond the horizon — reject, don't queue blind
+            return false;
+        }
+
+        if (free_head_ == NIL) [[unlikely]] {
+            rejected_++;
+            return false;
+        }
+
+        // Pop a pool entry, serialize into it, hang it on the wheel
+        const uint32_t idx = free_head_;
+        Entry& entry = pool_[idx];
+        free_head_ = entry.next;
+
+        std::memcpy(entry.data, data, len);
+        entry.len = static_cast<uint16_t>(len);
+        entry.launch_tsc = launch_tsc;
+        entry.slot_tick = slot_tick;
+
+        const size_t slot = slot_tick & (WheelSlots - 1);
+        entry.next = wheel_[slot];
+        wheel_[slot] = idx;
+
+        scheduled_++;
+        pending_++;
+        return true;
+    }
+
+    /// Convenience: launch this many nanoseconds from now
+    bool schedule_in(const uint8_t* data, size_t len, uint64_t delay_ns) {
+        return schedule_at(data, len,
+                           get_timestamp() +
+                               tsc_calibration().to_ticks(delay_ns));
+    }
+
+    /**
+     * @brief Drain due slots (call from the polling core's busy loop)
+     *
+     * Cost when nothing is due: one divide-free compare. With hardware
+     * launch-time the drain runs HW_HANDOFF_SLOTS ahead and the NIC
+     * holds each frame to its descriptor launch time; in software mode
+     * the drain releases exactly-due slots (jitter ≤ slot resolution).
+     *
+     * @return packets handed to the driver this call
+     */
+    inline size_t poll(uint64_t now_tsc = get_timestamp()) {
+        uint64_t target = now_tsc / slot_ticks_;
+        if constexpr (detail::has_submit_tx_at<Driver>::value) {
+            target += HW_HANDOFF_SLOTS;  // Pre-stage; hardware holds the trigger
+        }
+
+        if (cursor_ >= target) [[likely]] {
+            return 0;  // Nothing due — back to packet polling
+        }
+
+        size_t sent = 0;
+        while (cursor_ < target) {
+            sent += drain_slot(cursor_);
+            cursor_++;
+        }
+        return sent;
+    }
+
+    uint64_t scheduled() const { return scheduled_; }
+    uint64_t sent() const { return sent_; }
+    /// Scheduled with a launch time already in the past (sent immediately)
+    uint64_t late() const { return late_; }
+    /// Refused: past the horizon or pool exhausted
+    uint64_t rejected() const { return rejected_; }
+    /// Entries currently waiting on the wheel. Counted directly (enqueue
+    /// increments, drain decrements) — deriving it as scheduled_ - sent_
+    /// underflows once the late path submits without ever enqueueing
+    uint64_t pending() const { return pending_; }
+
+private:
+    static constexpr uint32_t NIL = UINT32_MAX;
+
+    struct Entry {
+        uint64_t launch_tsc;
+        uint64_t slot_tick;   // Absolute slot — disambiguates wheel laps
+        uint32_t next;
+        uint16_t len;
+        uint8_t data[MaxPacket];
+    };
+
+    /// Release every entry in a slot that belongs to this lap; entries
+    /// scheduled a full wheel revolution later stay put
+    size_t drain_slot(uint64_t slot_tick) {
+        const size_t slot = slot_tick & (WheelSlots - 1);
+
+        uint32_t idx = wheel_[slot];
+        uint32_t keep_head = NIL;
+        size_t sent = 0;
+
+        while (idx != NIL) {
+            Entry& entry = pool_[idx];
+            const uint32_t next = entry.next;
+
+            if (entry.slot_tick == slot_tick) {
+                submit(entry.data, entry.len, entry.launch_tsc);
+                entry.next = free_head_;
+                free_head_ = idx;
+                pending_--;  // Off the wheel whether or not the driver took it
+                sent++;
+            } else {
+                // Future lap — re-link and leave on the wheel
+                entry.next = keep_head;
+                keep_head = idx;
+            }
+            idx = next;
+        }
+
+        wheel_[slot] = keep_head;
+        return sent;
+    }
+
+    /// Hand one packet to the driver — descriptor launch-time when the
+    /// hardware has it, immediate submit_tx otherwise
+    inline bool submit(const uint8_t* data, size_t len, uint64_t launch_tsc) {
+        bool ok;
+        if constexpr (detail::has_submit_tx_at<Driver>::value) {
+            ok = driver_.submit_tx_at(data, len,
+                                      tsc_calibration().to_ns(launch_tsc));
+        } else {
+            ok = driver_.submit_tx(data, len);
+        }
+        if (ok) {
+            sent_++;
+        }
+        return ok;
+    }
+
+    Driver& driver_;
+    uint64_t slot_ticks_;
+    uint64_t cursor_;       // Next slot tick to drain
+
+    uint32_t wheel_[WheelSlots];
+    Entry pool_[PoolSize];
+    uint32_t free_head_;
+
+    uint64_t scheduled_ = 0;
+    uint64_t pending_ = 0;   // Wheel occupancy (see pending())
+    uint64_t sent_ = 0;
+    uint64_t late_ = 0;
+    uint64_t rejected_ = 0;
+};
+
+} // namespace ull_nic
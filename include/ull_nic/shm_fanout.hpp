@@ -0,0 +1,387 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <cstddef>
+#include <cstring>
+#include <cstdio>
+#include <type_traits>
+
+#ifdef __linux__
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
+/**
+ * @file shm_fanout.hpp
+ * @brief Shared-memory SPMC fan-out: one RX writer, N reader processes
+ *
+ * Why not N sockets or N queues:
+ * ──────────────────────────────
+ *
+ * The strategy, the risk monitor, and the recorder run as separate
+ * PROCESSES. Feeding each its own socket means the NIC delivers the
+ * feed three times; feeding them from one process means three copies
+ * through three queues. Either way the trading core pays for consumers
+ * that should be invisible to it.
+ *
+ * The fan-out ring fixes the economics: the RX core writes each record
+ * ONCE into a hugepage shared-memory ring, and readers attach READ-ONLY
+ * and consume at their own pace. One DMA, one write, N zero-copy
+ * readers — and because readers never write the shared lines (no
+ * consumer index in shared memory, no refcounts), a slow risk process
+ * cannot bounce a single cache line back at the trading core.
+ *
+ * The price of reader independence: the writer NEVER waits. A reader
+ * that falls a full ring behind gets LAPPED — it detects the overrun
+ * via the slot sequence numbers, counts the gap in its local drop
+ * accounting, and resynchronizes at the head. Slow consumers lose data;
+ * the hot path loses nothing.
+ *
+ * Concurrency scheme (seqlock per slot):
+ * - Slot i carries an atomic sequence. Publishing record s (1-based)
+ *   into slot (s-1) % N goes: seq := 0 (torn marker) → payload stores →
+ *   seq := s (release)
+ * - A reader expecting s loads seq (acquire), copies the payload, then
+ *   re-loads seq after an acquire fence. seq == s both times → clean
+ *   copy; seq < s → not published yet; seq > s (either load) → lapped
+ */
+
+namespace ull_nic {
+
+// ============================================================================
+// Shared Layout
+// ============================================================================
+
+struct ShmFanoutHeader {
+    static constexpr uint64_t MAGIC = 0x31544F4E41465355ULL;  // "USFANOT1"
+
+    uint64_t magic;
+    uint64_t capacity;       // Slots in the ring
+    uint64_t payload_size;   // sizeof(T) — rejected on mismatch at attach
+    uint64_t _pad;
+
+    // Publication cursor: records published so far. Readers use it to
+    // resynchronize after an overrun. On its own cache line so the
+    // writer's updates don't share a line with the (read-only) geometry.
+    alignas(64) std::atomic<uint64_t> cursor;
+};
+
+// ============================================================================
+// Writer (the RX core's side)
+// ============================================================================
+
+/**
+ * Creates and owns the shared ring. Single writer, publish() only from
+ * the RX core. Capacity must be a power of two — it sets how far the
+ * slowest reader may lag before being lapped (4096 MarketTicks ≈ 1.6 MB
+ * ≈ 4 ms of headroom at 1M ticks/sec).
+ */
+template<typename T, size_t Capacity = 4096>
+class ShmFanoutWriter {
+    static_assert((Capacity & (Capacity - 1)) == 0,
+                  "Capacity must be a power of two");
+    static_assert(std::is_trivially_copyable<T>::value,
+                  "Fan-out payloads cross process boundaries — POD only");
+
+public:
+    ShmFanoutWriter() = default;
+
+    ~ShmFanoutWriter() {
+        close_ring(true);
+    }
+
+    ShmFanoutWriter(const ShmFanoutWriter&) = delete;
+    ShmFanoutWriter& operator=(const ShmFanoutWriter&) = delete;
+
+    /**
+     * @brief Create the ring at /dev/hugepages/<name> (hugetlbfs),
+     *        falling back to /dev/shm/<name> when no hugepages are free
+     */
+    bool create(const char* name) {
+        #ifdef __linux__
+        close_ring(true);
+        std::snprintf(name_, sizeof(name_), "%s", name);
+
+        // Hugetlbfs first: 2 MB pages mean the whole ring lives in a
+        // handful of TLB entries on every attached process
+        if (!open_backing("/dev/hugepages/%s", name, true) &&
+            !open_backing("/dev/shm/%s", name, false)) {
+            return false;
+        }
+
+        hdr_->magic = 0;  // Not valid until fully initialized
+        hdr_->capacity = Capacity;
+        hdr_->payload_size = sizeof(T);
+        hdr_->cursor.store(0, std::memory_order_relaxed);
+        std::memset(static_cast<void*>(slots_), 0, sizeof(Slot) * Capacity);
+
+        // Publish the magic LAST — a reader attaching mid-create sees
+        // either no file or an invalid header, never a torn ring
+        std::atomic_thread_fence(std::memory_order_release);
+        hdr_->magic = ShmFanoutHeader::MAGIC;
+        return true;
+        #else
+        (void)name;
+        return false;
+        #endif
+    }
+
+    /**
+     * @brief Publish one record (HOT PATH — never blocks, never waits)
+     *
+     * One torn-marker store, one payload copy, two release stores.
+     * Readers that can't keep up get lapped; that's their problem by
+     * design — the RX core's cost is constant.
+     */
+    inline void publish(const T& record) {
+        const uint64_t seq = sequence_ + 1;  // 1-based publication number
+        Slot& slot = slots_[(seq - 1) & (Capacity - 1)];
+
+        // Torn marker: a reader mid-copy revalidates and discards
+        slot.seq.store(0, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+
+        std::memcpy(&slot.payload, &record, sizeof(T));
+
+        slot.seq.store(seq, std::memory_order_release);
+        sequence_ = seq;
+        hdr_->cursor.store(seq, std::memory_order_release);
+    }
+
+    uint64_t published() const { return sequence_; }
+
+    bool valid() const { return hdr_ != nullptr; }
+
+private:
+    struct alignas(64) Slot {
+        std::atomic<uint64_t> seq;
+        T payload;
+    };
+
+    bool open_backing(const char* path_fmt, const char* name, bool huge) {
+        char path[512];
+        std::snprintf(path, sizeof(path), path_fmt, name);
+
+        const int fd = ::open(path, O_CREAT | O_RDWR, 0644);
+        if (fd < 0) {
+            return false;
+        }
+
+        const size_t raw = sizeof(ShmFanoutHeader) + sizeof(Slot) * Capacity;
+        // hugetlbfs requires the mapping be a multiple of the page size
+        const size_t page = huge ? (2ULL << 20) : 4096;
+        const size_t total = (raw + page - 1) & ~(page - 1);
+
+        if (ftruncate(fd, static_cast<off_t>(total)) != 0) {
+            ::close(fd);
+            return false;
+        }
+
+        void* map = mmap(nullptr, total, PROT_READ | PROT_WRITE,
+                         MAP_SHARED, fd, 0);
+        if (map == MAP_FAILED) {
+            ::close(fd);
+            return false;
+        }
+
+        fd_ = fd;
+        map_size_ = total;
+        hdr_ = static_cast<ShmFanoutHeader*>(map);
+        slots_ = reinterpret_cast<Slot*>(
+            static_cast<uint8_t*>(map) + sizeof(ShmFanoutHeader));
+        std::snprintf(backing_path_, sizeof(backing_path_), "%s", path);
+        return true;
+    }
+
+    void close_ring(bool unlink_file) {
+        #ifdef __linux__
+        if (hdr_) {
+            munmap(hdr_, map_size_);
+            hdr_ = nullptr;
+            slots_ = nullptr;
+        }
+        if (fd_ >= 0) {
+            ::close(fd_);
+            fd_ = -1;
+        }
+        if (unlink_file && backing_path_[0]) {
+            ::unlink(backing_path_);
+            backing_path_[0] = '\0';
+        }
+        #else
+        (void)unlink_file;
+        #endif
+    }
+
+    ShmFanoutHeader* hdr_ = nullptr;
+    Slot* slots_ = nullptr;
+    size_t map_size_ = 0;
+    int fd_ = -1;
+    uint64_t sequence_ = 0;  // Writer-private (readers use slot seqs)
+    char name_[256] = {0};
+    char backing_path_[512] = {0};
+};
+
+// ============================================================================
+// Reader (strategy / risk / recorder processes)
+// ============================================================================
+
+/**
+ * Attaches READ-ONLY. Each reader keeps its own cursor and drop count
+ * in process-local memory — nothing a reader does touches the shared
+ * lines, so consumers are invisible to the writer and to each other.
+ */
+template<typename T, size_t Capacity = 4096>
+class ShmFanoutReader {
+public:
+    ShmFanoutReader() = default;
+
+    ~ShmFanoutReader() {
+        detach();
+    }
+
+    ShmFanoutReader(const ShmFanoutReader&) = delete;
+    ShmFanoutReader& operator=(const ShmFanoutReader&) = delete;
+
+    /**
+     * @brief Attach to a ring by name; starts consuming at the current
+     *        head (history before attach is not replayed)
+     */
+    bool attach(const char* name) {
+        #ifdef __linux__
+        detach();
+
+        char path[512];
+        std::snprintf(path, sizeof(path), "/dev/hugepages/%s", name);
+        int fd = ::open(path, O_RDONLY);
+        if (fd < 0) {
+            std::snprintf(path, sizeof(path), "/dev/shm/%s", name);
+            fd = ::open(path, O_RDONLY);
+        }
+        if (fd < 0) {
+            return false;
+        }
+
+        struct stat st;
+        if (fstat(fd, &st) != 0 ||
+            static_cast<size_t>(st.st_size) < sizeof(ShmFanoutHeader)) {
+            ::close(fd);
+            return false;
+        }
+        map_size_ = static_cast<size_t>(st.st_size);
+
+        void* map = mmap(nullptr, map_size_, PROT_READ, MAP_SHARED, fd, 0);
+        ::close(fd);  // Mapping keeps the backing alive
+        if (map == MAP_FAILED) {
+            return false;
+        }
+
+        hdr_ = static_cast<const ShmFanoutHeader*>(map);
+        if (hdr_->magic != ShmFanoutHeader::MAGIC ||
+            hdr_->capacity != Capacity ||
+            hdr_->payload_size != sizeof(T)) {
+            // Geometry mismatch — a reader built against a different T
+            // or capacity must fail loudly, not misread slots
+            detach();
+            return false;
+        }
+
+        slots_ = reinterpret_cast<const Slot*>(
+            reinterpret_cast<const uint8_t*>(map) + sizeof(ShmFanoutHeader));
+
+        // Start at the live head — a risk monitor attaching at noon
+        // wants the market now, not the open
+        next_seq_ = hdr_->cursor.load(std::memory_order_acquire) + 1;
+        attach_skip_ = next_seq_ - 1;
+        return true;
+        #else
+        (void)name;
+        return false;
+        #endif
+    }
+
+    /**
+     * @brief Non-blocking poll for the next record
+     *
+     * @return true with a clean copy in out; false when nothing new is
+     *         published yet (overruns are absorbed internally: the
+     *         reader resyncs at the head and adds the gap to drops())
+     */
+    inline bool poll(T& out) {
+        const Slot& slot = slots_[(next_seq_ - 1) & (Capacity - 1)];
+
+        const uint64_t seq_before = slot.seq.load(std::memory_order_acquire);
+        if (seq_before < next_seq_) {
+            return false;  // Not published yet (or mid-overwrite)
+        }
+        if (seq_before > next_seq_) [[unlikely]] {
+            resync();
+            return false;  // Lapped — caller polls again from the head
+        }
+
+        std::memcpy(&out, &slot.payload, sizeof(T));
+
+        // Seqlock validation: if the writer touched the slot during the
+        // copy, the sequence moved (to 0 or a later lap) — discard
+        std::atomic_thread_fence(std::memory_order_acquire);
+        const uint64_t seq_after = slot.seq.load(std::memory_order_relaxed);
+        if (seq_after != next_seq_) [[unlikely]] {
+            resync();
+            return false;
+        }
+
+        next_seq_++;
+        return true;
+    }
+
+    /// Records this reader missed by falling a full ring behind
+    uint64_t drops() const { return drops_; }
+
+    /// Records successfully consumed
+    uint64_t consumed() const { return next_seq_ - 1 - drops_ - attach_skip_; }
+
+    bool valid() const { return hdr_ != nullptr; }
+
+    void detach() {
+        #ifdef __linux__
+        if (hdr_) {
+            munmap(const_cast<void*>(static_cast<const void*>(hdr_)), map_size_);
+            hdr_ = nullptr;
+            slots_ = nullptr;
+        }
+        #endif
+    }
+
+private:
+    struct alignas(64) Slot {
+        std::atomic<uint64_t> seq;
+        T payload;
+    };
+
+    /// Lapped: jump to the oldest record guaranteed still intact and
+    /// account the gap as drops (per-reader, process-local)
+    void resync() {
+        const uint64_t head = hdr_->cursor.load(std::memory_order_acquire);
+        // Resume half a ring behind the head: far enough forward to be
+        // outside the writer's immediate path, far enough back to keep
+        // data. Everything between next_seq_ and there is lost.
+        uint64_t resume = (head > Capacity / 2) ? (head - Capacity / 2 + 1) : 1;
+        if (resume < next_seq_) {
+            resume = next_seq_;  // Spurious (torn slot, no actual lap)
+        }
+        drops_ += resume - next_seq_;
+        next_seq_ = resume;
+    }
+
+    const ShmFanoutHeader* hdr_ = nullptr;
+    const Slot* slots_ = nullptr;
+    size_t map_size_ = 0;
+    uint64_t next_seq_ = 1;
+    uint64_t drops_ = 0;
+    uint64_t attach_skip_ = 0;
+};
+
+} // namespace ull_nic
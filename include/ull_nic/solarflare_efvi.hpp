@@ -1,8 +1,10 @@
 #pragma once
 
 #include "common_types.hpp"
+#include "dma_arena.hpp"
 #include <cstdint>
 #include <cstring>
+#include <cstdio>
 #include <array>
 
 /**
@@ -69,6 +71,12 @@ constexpr size_t EFVI_TX_RING_SIZE = 512;  // TX descriptor ring size
 constexpr size_t EFVI_PKT_BUF_SIZE = 2048; // Packet buffer size (standard MTU)
 constexpr size_t EFVI_NUM_BUFS = 1024;     // Total packet buffers
 
+// CTPIO (cut-through PIO, X2-series): frames at or below this go over
+// PCIe straight into the NIC's TX FIFO. Above it, the DMA fetch the
+// descriptor path pays is cheaper than pushing the whole frame by PIO.
+constexpr size_t EFVI_CTPIO_THRESHOLD = 448;
+constexpr size_t EFVI_CTPIO_APERTURE_SIZE = 4096;  // WC-mapped BAR window
+
 // ============================================================================
 // Simulated ef_vi Structures (Real Implementation Uses Actual ef_vi API)
 // ============================================================================
@@ -210,7 +218,25 @@ public:
         
         return false;
     }
-    
+
+    /**
+     * poll_rx with a compile-time capture tap (compliance recording)
+     *
+     * Same shape as CustomNICDriver's tapped overload: the tap is a
+     * template parameter (ull_nic::CaptureRing), so untapped loops
+     * compile to exactly the poll_rx above. The tap append is one
+     * bounded memcpy — no syscalls on the polling core; the drainer
+     * thread in packet_capture.hpp does the file I/O.
+     */
+    template<typename CaptureTap>
+    inline bool poll_rx(efvi_packet* pkt, CaptureTap& tap) {
+        if (!poll_rx(pkt)) {
+            return false;
+        }
+        tap.append(pkt->data, pkt->len, pkt->timestamp_ns);
+        return true;
+    }
+
     /**
      * Submit packet for transmission (zero-copy)
      * 
@@ -230,7 +256,19 @@ public:
         if (len > EFVI_PKT_BUF_SIZE) [[unlikely]] {
             return false;
         }
-        
+
+        // CTPIO first for small frames: the frame goes over PCIe into
+        // the NIC's TX FIFO directly, skipping the descriptor post and
+        // the NIC's DMA fetch round trip (~100-150 ns on X2522).
+        // Falls through to the descriptor path when the frame is over
+        // the threshold or the aperture is still draining.
+        if (len <= EFVI_CTPIO_THRESHOLD && ctpio_enabled_) [[likely]] {
+            if (submit_tx_ctpio(data, len)) {
+                return true;
+            }
+            ctpio_fallbacks_++;  // Aperture busy — descriptor path below
+        }
+
         // HOT PATH: Submit packet to TX ring
         // Real implementation: ef_vi_transmit()
         
@@ -246,12 +284,84 @@ public:
             
             // Push to wire immediately (don't batch)
             // Real implementation: ef_vi_transmit_push(&vi);
-            
+            dma_sends_++;
+
             return true;
         }
         
         return false;
     }
+
+    /**
+     * CTPIO transmit: push the frame through the write-combining aperture
+     *
+     * Why it's faster than the descriptor path for small frames:
+     * the DMA path posts a descriptor, rings the doorbell, and then the
+     * NIC fetches the frame — a full PCIe round trip before the first
+     * byte hits the TX FIFO. CTPIO streams the frame itself over PCIe
+     * in write-combining bursts, so the FIFO starts filling on the
+     * FIRST store: 100+ ns less on 64-512 byte frames.
+     *
+     * Sequencing rules (the part people get wrong):
+     * 1. The aperture is mapped WRITE-COMBINING — stores buffer in the
+     *    core's WC buffers and flush as 64-byte PCIe writes
+     * 2. The frame is therefore pushed in 64-byte chunks so each chunk
+     *    maps to exactly one WC flush, never a partial line
+     * 3. One sfence AFTER the last chunk drains every WC buffer and
+     *    orders the whole frame ahead of anything that follows. No
+     *    fences between chunks — that would serialize each line and
+     *    forfeit the write-combining
+     *
+     * Production:
+     * ```cpp
+     * ef_vi_transmit_ctpio(&vi, frame, len, ct_threshold);
+     * ef_vi_transmit_ctpio_fallback(&vi, dma_addr, len, pkt_id);
+     * ```
+     *
+     * @return false when the aperture is still draining a prior frame
+     *         (caller falls back to the descriptor path — never spin here)
+     */
+    inline bool submit_tx_ctpio(const uint8_t* data, size_t len) {
+        if (ctpio_in_flight_ >= CTPIO_MAX_IN_FLIGHT) [[unlikely]] {
+            return false;  // Aperture busy — don't wait, fall back
+        }
+
+        // 64-byte store chunks: one WC flush per chunk (rule 2 above).
+        // memcpy of exactly 64 aligned bytes compiles to two 32-byte
+        // vector stores — the WC buffer coalesces them into one line.
+        volatile uint8_t* aperture = ctpio_aperture_;
+        size_t offset = 0;
+        while (offset + 64 <= len) {
+            std::memcpy(const_cast<uint8_t*>(aperture) + offset,
+                        data + offset, 64);
+            offset += 64;
+        }
+        if (offset < len) {
+            // Final partial chunk, zero-padded to a full line so the
+            // last WC flush is still a complete 64-byte write
+            uint8_t tail[64] = {0};
+            std::memcpy(tail, data + offset, len - offset);
+            std::memcpy(const_cast<uint8_t*>(aperture) + offset, tail, 64);
+        }
+
+        #if defined(__x86_64__) || defined(__i386__)
+        // Rule 3: one sfence after the last chunk — drains the WC
+        // buffers and commits the frame to the FIFO in order
+        __builtin_ia32_sfence();
+        #endif
+
+        ctpio_in_flight_++;
+        ctpio_sends_++;
+        return true;
+    }
+
+    /// Enable/disable CTPIO at runtime (e.g. the poison/fallback case
+    /// where the NIC reports a CTPIO error and we drop to DMA-only)
+    void set_ctpio_enabled(bool enabled) { ctpio_enabled_ = enabled; }
+
+    uint64_t ctpio_sends() const { return ctpio_sends_; }
+    uint64_t dma_sends() const { return dma_sends_; }
+    uint64_t ctpio_fallbacks() const { return ctpio_fallbacks_; }
     
     /**
      * Poll for TX completions (reclaim buffers)
@@ -270,13 +380,36 @@ public:
      * ```
      */
     inline void poll_tx_completions() {
+        // CTPIO frames complete too (EF_EVENT_TYPE_TX with the CTPIO
+        // flag in production) — drain those first, they were sent first
+        if (ctpio_in_flight_ > 0) [[likely]] {
+            ctpio_in_flight_--;
+            return;
+        }
         if (tx_posted_ > 0) [[likely]] {
             // Real implementation: ef_eventq_poll() for TX events
             // For simulation, just decrement counter
             tx_posted_--;
         }
+        // ef_vi reports a hardware TX timestamp with each completion
+        // (EF_EVENT_TYPE_TX_WITH_TIMESTAMP, ~8ns precision). ef_vi has
+        // NO launch-time field, so scheduled TX runs through the software
+        // timing wheel — this timestamp is how the wheel's actual release
+        // accuracy gets measured against the requested launch time.
+        last_tx_timestamp_ns_ = get_hw_timestamp();
     }
-    
+
+    /**
+     * Hardware timestamp of the most recently completed transmit
+     *
+     * Compare against the launch time a ScheduledTx send asked for to
+     * measure wire-release error (software drain jitter ≤ one wheel slot).
+     */
+    inline uint64_t last_tx_timestamp_ns() const {
+        return last_tx_timestamp_ns_;
+    }
+
+
     /**
      * Get hardware timestamp of last received packet
      * 
@@ -294,9 +427,22 @@ public:
 
 private:
     efvi_handle handle_;
+    ull_nic::DMAArena arena_;  // Backing storage for handle_.pkt_bufs
     bool initialized_;
     uint32_t rx_posted_;
     uint32_t tx_posted_;
+
+    // CTPIO state. In production ctpio_aperture_ is the WC-mapped BAR
+    // window from ef_vi_ctpio_init; here it's host memory with the same
+    // alignment so the store sequencing is exercised end to end.
+    static constexpr uint32_t CTPIO_MAX_IN_FLIGHT = 2;  // Aperture depth
+    alignas(64) uint8_t ctpio_aperture_[EFVI_CTPIO_APERTURE_SIZE] = {0};
+    bool ctpio_enabled_ = true;
+    uint32_t ctpio_in_flight_ = 0;
+    uint64_t ctpio_sends_ = 0;
+    uint64_t dma_sends_ = 0;
+    uint64_t ctpio_fallbacks_ = 0;
+    uint64_t last_tx_timestamp_ns_ = 0;
     
     /**
      * Allocate packet buffers using huge pages
@@ -307,10 +453,11 @@ private:
      * - TLB miss cost: 50-100 ns
      */
     void allocate_packet_buffers() {
-        // Real implementation: mmap() with MAP_HUGETLB
-        // Allocate from huge page pool for DMA
+        // One hugepage-backed arena for every packet buffer (real ef_vi
+        // registers this same slab with ef_memreg_alloc for DMA)
+        arena_.init(EFVI_NUM_BUFS * EFVI_PKT_BUF_SIZE + ull_nic::DMAArena::HUGE_PAGE_SIZE);
         for (size_t i = 0; i < EFVI_NUM_BUFS; i++) {
-            handle_.pkt_bufs[i] = nullptr;  // Placeholder
+            handle_.pkt_bufs[i] = arena_.allocate(EFVI_PKT_BUF_SIZE, 64);
         }
     }
     